@@ -0,0 +1,161 @@
+// File: alloc_count.c
+//
+// Description: module for an interposed allocator call counter
+//
+// Built with -DALC_INTERPOSE, this module defines malloc, calloc, realloc,
+// free and the aligned allocators (posix_memalign, aligned_alloc and
+// memalign) itself, counting each call before handing it to the C
+// library's own allocator. Calls from inside the C library (stdio
+// buffers, for example) resolve to these definitions too, so a count
+// that does not move across a stretch of code proves it allocated
+// nothing. Without the flag the functions below report no counting.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "alloc_count.h"
+
+
+
+#ifdef ALC_INTERPOSE
+
+#include <errno.h>
+
+
+
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t count, size_t size);
+extern void * __libc_realloc(void * ptr, size_t size);
+extern void __libc_free(void * ptr);
+extern void * __libc_memalign(size_t alignment, size_t size);
+// glibc's allocator entry points behind the public names
+
+
+
+static size_t calls = 0;
+// allocator calls so far
+
+
+
+void * malloc(size_t size) {
+
+    calls++;
+    return __libc_malloc(size);
+
+}
+
+
+
+void * calloc(size_t count, size_t size) {
+
+    calls++;
+    return __libc_calloc(count, size);
+
+}
+
+
+
+void * realloc(void * ptr, size_t size) {
+
+    calls++;
+    return __libc_realloc(ptr, size);
+
+}
+
+
+
+void free(void * ptr) {
+
+    calls++;
+    __libc_free(ptr);
+
+}
+
+
+
+int posix_memalign(void ** ptr, size_t alignment, size_t size) {
+
+    calls++;
+
+    if (alignment == 0 || alignment % sizeof(void *) != 0 ||
+        (alignment & (alignment - 1)) != 0)  // not a power of two pointers
+        return EINVAL;
+
+    void * block = __libc_memalign(alignment, size);
+
+    if (block == NULL)
+        return ENOMEM;
+
+    *ptr = block;
+    return 0;
+
+}
+
+
+
+void * aligned_alloc(size_t alignment, size_t size) {
+
+    calls++;
+    return __libc_memalign(alignment, size);
+
+}
+
+
+
+void * memalign(size_t alignment, size_t size) {
+
+    calls++;
+    return __libc_memalign(alignment, size);
+
+}
+
+
+
+/// Reports that calls are counted.
+
+int alc_active(void) {
+
+    return 1;
+
+}
+
+
+
+/// Fetches the call count.
+
+size_t alc_calls(void) {
+
+    return calls;
+
+}
+
+
+
+#else
+
+
+
+/// Reports that calls are not counted.
+
+int alc_active(void) {
+
+    return 0;
+
+}
+
+
+
+/// Fetches the (absent) call count.
+
+size_t alc_calls(void) {
+
+    return 0;
+
+}
+
+
+
+#endif  // ALC_INTERPOSE
@@ -0,0 +1,37 @@
+// File: alloc_count.h
+//
+// Description: header for an interposed allocator call counter
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef ALLOC_COUNT_H
+#define ALLOC_COUNT_H
+
+#include <stdlib.h>
+
+
+
+/// Check whether allocator calls are being counted, which requires
+/// building alloc_count.c with -DALC_INTERPOSE (glibc only).
+///
+/// @return 1 if malloc, calloc, realloc, free, posix_memalign,
+///     aligned_alloc and memalign are interposed, else 0
+
+int alc_active(void);
+
+
+
+/// Get the number of calls to the interposed allocator functions made so
+/// far by the whole process, the C library included.
+///
+/// @return the call count (always 0 when not interposed)
+
+size_t alc_calls(void);
+
+
+
+#endif  // ALLOC_COUNT_H
@@ -0,0 +1,102 @@
+// File: arena.h
+//
+// Description: header for a bump allocator over (optionally huge) pages
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+
+/// Arena is a pointer to the Arena ADT.
+typedef struct Arena_s * Arena;
+
+
+
+#define ARN_HUGETLB  1
+// back chunks with reserved 2 MB pages (MAP_HUGETLB), falling back to
+// transparent huge pages (MADV_HUGEPAGE) when none are reserved
+
+#define ARN_POPULATE 2
+// prefault chunks when mapped (MAP_POPULATE)
+
+#define ARN_LOCK     4
+// lock chunks in memory (mlock)
+
+
+
+extern const size_t ARN_CHUNK;          /// < minimum chunk size (2 MB)
+
+
+
+/// Create an empty arena. Memory is mapped in chunks of at least
+/// ARN_CHUNK bytes as allocations need it.
+///
+/// @param flags - ARN_HUGETLB, ARN_POPULATE and ARN_LOCK, or-ed together
+///
+/// @return pointer to the Arena instance or NULL on failure
+
+Arena arn_create(int flags);
+
+
+
+/// Unmap every chunk, releasing all memory allocated from the arena.
+///
+/// @param arena - a pointer to an Arena instance
+
+void arn_destroy(Arena arena);
+
+
+
+/// Allocate memory from the arena, aligned for any object type.
+/// Memory is only released by arn_destroy.
+///
+/// @param arena - a pointer to an Arena instance
+/// @param size - the number of bytes
+///
+/// @return pointer to the memory or NULL on failure
+
+void * arn_alloc(Arena arena, size_t size);
+
+
+
+/// Get the bytes mapped by the arena.
+///
+/// @param arena - a pointer to an Arena instance
+///
+/// @return the total size of all chunks
+
+size_t arn_mapped(Arena arena);
+
+
+
+/// Get the bytes mapped with reserved huge pages (the rest use regular
+/// or transparent huge pages).
+///
+/// @param arena - a pointer to an Arena instance
+///
+/// @return the total size of the MAP_HUGETLB chunks
+
+size_t arn_huge(Arena arena);
+
+
+
+/// Check whether every chunk could be locked in memory.
+///
+/// @param arena - a pointer to an Arena instance
+///
+/// @return 1 if ARN_LOCK was asked for and no mlock failed, else 0
+
+int arn_locked(Arena arena);
+
+
+
+#endif  // ARENA_H
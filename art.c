@@ -0,0 +1,1152 @@
+// File: art.c
+//
+// Description: module for an Adaptive Radix Tree (ART) ADT
+//
+// Keys are split into their big-endian bytes, one byte per level. Inner
+// nodes grow through four sizes (Node4, Node16, Node48, Node256) as
+// children are added, single-child chains are collapsed into a stored
+// prefix, and Node16 finds a child with one SSE2 byte compare. Leaves are
+// tagged entry pointers. A miss falls back to the key's predecessor or
+// successor, whichever shares the longer prefix, as ibt_search does; both
+// come from the one descent, through the nearest siblings on its path.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include <stdint.h>
+#include <string.h>
+
+#include "art.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+
+#define NODE4   0
+#define NODE16  1
+#define NODE48  2
+#define NODE256 3
+// inner node types
+
+
+#define ARTDEPTH 4
+// most inner nodes on a root-to-leaf path (each consumes a key byte)
+
+
+#define IS_LEAF(ref) (((uintptr_t) (ref)) & 1)
+#define LEAF_ENTRY(ref) ((Entry) (((uintptr_t) (ref)) & ~(uintptr_t) 1))
+#define MAKE_LEAF(entry) ((void *) (((uintptr_t) (entry)) | 1))
+// child references are inner node pointers or tagged entry pointers
+
+
+
+/// ArtNode is a pointer to the header shared by every inner node type.
+typedef struct ArtNode_s * ArtNode;
+
+
+
+/// ArtNode_s is the inner node header.
+struct ArtNode_s {
+
+    unsigned char type;
+    unsigned char prefix_len;
+    unsigned short num_children;
+    unsigned char prefix[4];
+    // key bytes shared by every key below, skipped by path compression
+
+};
+
+
+
+/// Node4_s holds up to 4 children with sorted key bytes.
+struct Node4_s {
+
+    struct ArtNode_s n;
+    unsigned char keys[4];
+    void * children[4];
+
+};
+
+
+
+/// Node16_s holds up to 16 children with sorted key bytes.
+struct Node16_s {
+
+    struct ArtNode_s n;
+    unsigned char keys[16];
+    void * children[16];
+
+};
+
+
+
+/// Node48_s maps every key byte to one of up to 48 child slots.
+struct Node48_s {
+
+    struct ArtNode_s n;
+    unsigned char index[256];
+    // slot + 1 for each present key byte, 0 if absent
+    void * children[48];
+
+};
+
+
+
+/// Node256_s holds a child slot for every key byte.
+struct Node256_s {
+
+    struct ArtNode_s n;
+    void * children[256];
+
+};
+
+
+
+/// ArtStep_s is an inner node on a search path and the key byte taken.
+struct ArtStep_s {
+
+    ArtNode node;
+    unsigned char c;
+
+};
+
+
+
+/// Defines the struct for the Art ADT
+struct Art_s {
+
+    void * root;
+    // root reference
+
+    size_t num_nodes;
+    size_t leaf_nodes;
+    size_t node_bytes;
+    // tree data
+
+    void (*art_show_value_w)(Entry entry, FILE * stream);
+    // pointer to user-passed "show value" function
+
+    void (*art_delete_entry)(Entry entry);
+    // pointer to user-passed entry deletion function
+
+};
+
+
+
+/// Gets a key byte, with byte 0 the most significant.
+///
+/// @param key - the key
+/// @param depth - the byte position
+///
+/// @return the key byte
+
+static unsigned char art_key_byte(ikey_t key, size_t depth) {
+
+    return (key >> (BITSPERBYTE * (BYTESPERWORD - 1 - depth))) & (RADIX - 1);
+
+}
+
+
+
+/// Gets the allocation size of an inner node type.
+///
+/// @param type - the node type
+///
+/// @return size in bytes
+
+static size_t art_node_size(unsigned char type) {
+
+    switch (type) {
+
+        case NODE4:
+            return sizeof(struct Node4_s);
+
+        case NODE16:
+            return sizeof(struct Node16_s);
+
+        case NODE48:
+            return sizeof(struct Node48_s);
+
+        default:
+            return sizeof(struct Node256_s);
+
+    }
+
+}
+
+
+
+/// Allocates a zeroed inner node.
+///
+/// @param art - the Art instance
+/// @param type - the node type
+///
+/// @return the new node or NULL on failure
+
+static ArtNode art_make_node(Art art, unsigned char type) {
+
+    ArtNode node = (ArtNode) calloc(1, art_node_size(type));
+
+    if (node == NULL)  // signifies an allocation failure
+        return NULL;
+
+    node->type = type;
+
+    art->num_nodes++;
+    art->node_bytes += art_node_size(type);
+
+    return node;
+
+}
+
+
+
+/// Frees an inner node (not its children).
+///
+/// @param art - the Art instance
+/// @param node - the node to free
+
+static void art_free_node(Art art, ArtNode node) {
+
+    art->num_nodes--;
+    art->node_bytes -= art_node_size(node->type);
+    free(node);
+
+}
+
+
+
+/// Creates and returns the initial Art instance.
+
+Art art_create(void (*ext_show_value)(Entry entry, FILE * stream),
+    void (*ext_delete_entry)(Entry entry)) {
+
+    Art art = (Art) malloc(sizeof(struct Art_s));
+
+    if (art == NULL)  // signifies an allocation failure
+        return NULL;
+
+    art->root = NULL;
+    art->num_nodes = 0;
+    art->leaf_nodes = 0;
+    art->node_bytes = 0;
+    // sets initial values
+
+    art->art_show_value_w = ext_show_value;
+    art->art_delete_entry = ext_delete_entry;
+    // assigns user-passed functions
+
+    return art;
+
+}
+
+
+
+/// Gets the first child whose key byte is greater than c.
+///
+/// @param node - the inner node
+/// @param c - the byte to search past (-1 for the first child)
+///
+/// @return the child reference or NULL if none
+
+static void * art_child_after(ArtNode node, int c) {
+
+    switch (node->type) {
+
+        case NODE4: {
+
+            struct Node4_s * n = (struct Node4_s *) node;
+
+            for (int i = 0; i < node->num_children; i++)
+                if (n->keys[i] > c)
+                    return n->children[i];
+
+            return NULL;
+
+        }
+
+        case NODE16: {
+
+            struct Node16_s * n = (struct Node16_s *) node;
+
+            for (int i = 0; i < node->num_children; i++)
+                if (n->keys[i] > c)
+                    return n->children[i];
+
+            return NULL;
+
+        }
+
+        case NODE48: {
+
+            struct Node48_s * n = (struct Node48_s *) node;
+
+            for (int i = c + 1; i < (int) RADIX; i++)
+                if (n->index[i] != 0)
+                    return n->children[n->index[i] - 1];
+
+            return NULL;
+
+        }
+
+        default: {
+
+            struct Node256_s * n = (struct Node256_s *) node;
+
+            for (int i = c + 1; i < (int) RADIX; i++)
+                if (n->children[i] != NULL)
+                    return n->children[i];
+
+            return NULL;
+
+        }
+
+    }
+
+}
+
+
+
+/// Gets the last child whose key byte is less than c.
+///
+/// @param node - the inner node
+/// @param c - the byte to search before (RADIX for the last child)
+///
+/// @return the child reference or NULL if none
+
+static void * art_child_before(ArtNode node, int c) {
+
+    switch (node->type) {
+
+        case NODE4: {
+
+            struct Node4_s * n = (struct Node4_s *) node;
+
+            for (int i = node->num_children - 1; i >= 0; i--)
+                if (n->keys[i] < c)
+                    return n->children[i];
+
+            return NULL;
+
+        }
+
+        case NODE16: {
+
+            struct Node16_s * n = (struct Node16_s *) node;
+
+            for (int i = node->num_children - 1; i >= 0; i--)
+                if (n->keys[i] < c)
+                    return n->children[i];
+
+            return NULL;
+
+        }
+
+        case NODE48: {
+
+            struct Node48_s * n = (struct Node48_s *) node;
+
+            for (int i = c - 1; i >= 0; i--)
+                if (n->index[i] != 0)
+                    return n->children[n->index[i] - 1];
+
+            return NULL;
+
+        }
+
+        default: {
+
+            struct Node256_s * n = (struct Node256_s *) node;
+
+            for (int i = c - 1; i >= 0; i--)
+                if (n->children[i] != NULL)
+                    return n->children[i];
+
+            return NULL;
+
+        }
+
+    }
+
+}
+
+
+
+/// Finds the child slot for a key byte.
+///
+/// @param node - the inner node
+/// @param c - the key byte
+///
+/// @return pointer to the child slot or NULL if absent
+
+static void ** art_find_child(ArtNode node, unsigned char c) {
+
+    switch (node->type) {
+
+        case NODE4: {
+
+            struct Node4_s * n = (struct Node4_s *) node;
+
+            for (int i = 0; i < node->num_children; i++)
+                if (n->keys[i] == c)
+                    return &n->children[i];
+
+            return NULL;
+
+        }
+
+        case NODE16: {
+
+            struct Node16_s * n = (struct Node16_s *) node;
+
+#ifdef __SSE2__
+
+            __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char) c),
+                _mm_loadu_si128((__m128i *) n->keys));
+            unsigned int mask = (unsigned int) _mm_movemask_epi8(cmp) &
+                ((1u << node->num_children) - 1);
+            // one compare tests all 16 key bytes
+
+            if (mask == 0)
+                return NULL;
+
+            return &n->children[__builtin_ctz(mask)];
+
+#else
+
+            for (int i = 0; i < node->num_children; i++)
+                if (n->keys[i] == c)
+                    return &n->children[i];
+
+            return NULL;
+
+#endif
+
+        }
+
+        case NODE48: {
+
+            struct Node48_s * n = (struct Node48_s *) node;
+
+            if (n->index[c] == 0)
+                return NULL;
+
+            return &n->children[n->index[c] - 1];
+
+        }
+
+        default: {
+
+            struct Node256_s * n = (struct Node256_s *) node;
+
+            if (n->children[c] == NULL)
+                return NULL;
+
+            return &n->children[c];
+
+        }
+
+    }
+
+}
+
+
+
+/// Inserts a child into a sorted key array node (Node4 or Node16).
+///
+/// @param keys - the sorted key bytes
+/// @param children - the child references
+/// @param count - the current number of children
+/// @param c - the new key byte
+/// @param child - the new child reference
+
+static void art_sorted_add(unsigned char * keys, void ** children, int count,
+    unsigned char c, void * child) {
+
+    int pos = 0;
+
+    while (pos < count && keys[pos] < c)
+        pos++;
+
+    memmove(keys + pos + 1, keys + pos, count - pos);
+    memmove(children + pos + 1, children + pos, (count - pos) * sizeof(void *));
+
+    keys[pos] = c;
+    children[pos] = child;
+
+}
+
+
+
+/// Adds a child to an inner node, growing the node type if it is full.
+///
+/// @param art - the Art instance
+/// @param ref - the slot holding the node (updated if the node grows)
+/// @param c - the new key byte
+/// @param child - the new child reference
+///
+/// @return 1 on success, 0 if a grown node could not be allocated (the
+///     node is unchanged)
+
+static int art_add_child(Art art, void ** ref, unsigned char c,
+    void * child) {
+
+    ArtNode node = (ArtNode) *ref;
+
+    switch (node->type) {
+
+        case NODE4: {
+
+            struct Node4_s * n = (struct Node4_s *) node;
+
+            if (node->num_children < 4) {  // room left
+
+                art_sorted_add(n->keys, n->children, node->num_children, c,
+                    child);
+                node->num_children++;
+
+                return 1;
+
+            }
+
+            struct Node16_s * big = (struct Node16_s *)
+                art_make_node(art, NODE16);
+
+            if (big == NULL)  // handles memory error
+                return 0;
+
+            memcpy(&big->n, node, sizeof(struct ArtNode_s));
+            big->n.type = NODE16;
+            memcpy(big->keys, n->keys, 4);
+            memcpy(big->children, n->children, 4 * sizeof(void *));
+
+            art_free_node(art, node);
+            *ref = big;
+
+            return art_add_child(art, ref, c, child);
+
+        }
+
+        case NODE16: {
+
+            struct Node16_s * n = (struct Node16_s *) node;
+
+            if (node->num_children < 16) {  // room left
+
+                art_sorted_add(n->keys, n->children, node->num_children, c,
+                    child);
+                node->num_children++;
+
+                return 1;
+
+            }
+
+            struct Node48_s * big = (struct Node48_s *)
+                art_make_node(art, NODE48);
+
+            if (big == NULL)  // handles memory error
+                return 0;
+
+            memcpy(&big->n, node, sizeof(struct ArtNode_s));
+            big->n.type = NODE48;
+
+            for (int i = 0; i < 16; i++) {  // moves children into slots
+
+                big->children[i] = n->children[i];
+                big->index[n->keys[i]] = (unsigned char) (i + 1);
+
+            }
+
+            art_free_node(art, node);
+            *ref = big;
+
+            return art_add_child(art, ref, c, child);
+
+        }
+
+        case NODE48: {
+
+            struct Node48_s * n = (struct Node48_s *) node;
+
+            if (node->num_children < 48) {  // room left
+
+                n->children[node->num_children] = child;
+                n->index[c] = (unsigned char) (node->num_children + 1);
+                node->num_children++;
+
+                return 1;
+
+            }
+
+            struct Node256_s * big = (struct Node256_s *)
+                art_make_node(art, NODE256);
+
+            if (big == NULL)  // handles memory error
+                return 0;
+
+            memcpy(&big->n, node, sizeof(struct ArtNode_s));
+            big->n.type = NODE256;
+
+            for (int i = 0; i < (int) RADIX; i++)  // moves children by byte
+                if (n->index[i] != 0)
+                    big->children[i] = n->children[n->index[i] - 1];
+
+            art_free_node(art, node);
+            *ref = big;
+
+            return art_add_child(art, ref, c, child);
+
+        }
+
+        default: {
+
+            struct Node256_s * n = (struct Node256_s *) node;
+
+            n->children[c] = child;
+            node->num_children++;
+
+            return 1;
+
+        }
+
+    }
+
+}
+
+
+
+/// Recursively inserts a leaf below a slot.
+///
+/// @param art - the Art instance
+/// @param ref - the slot being inserted into
+/// @param entry - the new entry
+/// @param depth - key byte position of the slot
+///
+/// @return 1 if inserted, 0 if the key was already present, -1 on memory
+///     error (the subtree is unchanged)
+
+static int art_insert_rec(Art art, void ** ref, Entry entry, size_t depth) {
+
+    ikey_t key = entry->key;
+
+    if (IS_LEAF(*ref)) {  // splits a leaf into a Node4 over both keys
+
+        ikey_t old_key = LEAF_ENTRY(*ref)->key;
+
+        if (old_key == key)  // key already present
+            return 0;
+
+        ArtNode node = art_make_node(art, NODE4);
+
+        if (node == NULL)  // handles memory error
+            return -1;
+
+        while (art_key_byte(key, depth) == art_key_byte(old_key, depth))
+            node->prefix[node->prefix_len++] = art_key_byte(key, depth++);
+        // shared bytes become the new node's prefix
+
+        art_add_child(art, (void **) &node, art_key_byte(old_key, depth),
+            *ref);
+        // a new Node4 takes two children without growing, so cannot fail
+        art_add_child(art, (void **) &node, art_key_byte(key, depth),
+            MAKE_LEAF(entry));
+
+        *ref = node;
+        return 1;
+
+    }
+
+    ArtNode node = (ArtNode) *ref;
+    size_t p = 0;
+
+    while (p < node->prefix_len &&
+        node->prefix[p] == art_key_byte(key, depth + p))
+        p++;
+
+    if (p < node->prefix_len) {  // key leaves the prefix, so split it
+
+        ArtNode split = art_make_node(art, NODE4);
+
+        if (split == NULL)  // handles memory error
+            return -1;
+
+        split->prefix_len = (unsigned char) p;
+        memcpy(split->prefix, node->prefix, p);
+
+        unsigned char old_byte = node->prefix[p];
+        node->prefix_len -= (unsigned char) (p + 1);
+        memmove(node->prefix, node->prefix + p + 1, node->prefix_len);
+        // old node keeps the bytes after the split byte
+
+        art_add_child(art, (void **) &split, old_byte, node);
+        art_add_child(art, (void **) &split, art_key_byte(key, depth + p),
+            MAKE_LEAF(entry));
+
+        *ref = split;
+        return 1;
+
+    }
+
+    depth += node->prefix_len;
+
+    void ** child = art_find_child(node, art_key_byte(key, depth));
+
+    if (child != NULL)  // descends into the existing child
+        return art_insert_rec(art, child, entry, depth + 1);
+
+    if (!art_add_child(art, ref, art_key_byte(key, depth), MAKE_LEAF(entry)))
+        return -1;
+
+    return 1;
+
+}
+
+
+
+/// Inserts a new entry into the Art instance.
+
+int art_insert(Art art, ikey_t key, ival_t value) {
+
+    Entry entry = (Entry) malloc(sizeof(struct Entry_s));
+
+    if (entry == NULL)  // handles memory error
+        return -1;
+
+    entry->key = key;
+    entry->value = value;
+
+    if (art->root == NULL) {  // handles empty tree case
+
+        art->root = MAKE_LEAF(entry);
+        art->leaf_nodes = 1;
+
+        return 1;
+
+    }
+
+    int inserted = art_insert_rec(art, &art->root, entry, 0);
+
+    if (inserted == 1)
+        art->leaf_nodes++;
+    else  // discards duplicate key entry, or the entry left out on failure
+        free(entry);
+
+    return inserted;
+
+}
+
+
+
+/// Gets the smallest entry below a reference.
+///
+/// @param ref - the subtree reference
+///
+/// @return the leftmost entry
+
+static Entry art_minimum(void * ref) {
+
+    while (!IS_LEAF(ref))
+        ref = art_child_after((ArtNode) ref, -1);
+
+    return LEAF_ENTRY(ref);
+
+}
+
+
+
+/// Gets the largest entry below a reference.
+///
+/// @param ref - the subtree reference
+///
+/// @return the rightmost entry
+
+static Entry art_maximum(void * ref) {
+
+    while (!IS_LEAF(ref))
+        ref = art_child_before((ArtNode) ref, (int) RADIX);
+
+    return LEAF_ENTRY(ref);
+
+}
+
+
+
+/// Finds the predecessor subtree nearest a search path: the closest
+/// lower sibling of the deepest step that has one.
+///
+/// @param path - the inner nodes taken and their key bytes
+/// @param steps - the number of steps on the path
+///
+/// @return the largest entry below that sibling, or NULL if none
+
+static Entry art_path_before(struct ArtStep_s * path, size_t steps) {
+
+    while (steps-- > 0) {  // deeper siblings are closer to the key
+
+        void * prev = art_child_before(path[steps].node, path[steps].c);
+
+        if (prev != NULL)
+            return art_maximum(prev);
+
+    }
+
+    return NULL;
+
+}
+
+
+
+/// Finds the successor subtree nearest a search path: the closest upper
+/// sibling of the deepest step that has one.
+///
+/// @param path - the inner nodes taken and their key bytes
+/// @param steps - the number of steps on the path
+///
+/// @return the smallest entry below that sibling, or NULL if none
+
+static Entry art_path_after(struct ArtStep_s * path, size_t steps) {
+
+    while (steps-- > 0) {  // deeper siblings are closer to the key
+
+        void * next = art_child_after(path[steps].node, path[steps].c);
+
+        if (next != NULL)
+            return art_minimum(next);
+
+    }
+
+    return NULL;
+
+}
+
+
+
+/// Searches an Art instance to find the closest match to a key.
+
+Entry art_search(Art art, ikey_t key) {
+
+    if (art->root == NULL) {  // handles unexpected empty tree error
+
+        fprintf(stderr, "error: cannot query an empty tree\n");
+        art_destroy(art);
+
+        exit(EXIT_FAILURE);
+
+    }
+
+    struct ArtStep_s path[ARTDEPTH];
+    size_t steps = 0;
+    // the descent is kept so a miss finds its neighbors without another
+
+    void * ref = art->root;
+    size_t depth = 0;
+    Entry pred;
+    Entry succ;
+
+    while (1) {  // descent loop
+
+        if (IS_LEAF(ref)) {  // one neighbor is the leaf reached
+
+            Entry leaf = LEAF_ENTRY(ref);
+
+            if (leaf->key == key)  // exact match
+                return leaf;
+
+            if (leaf->key < key) {
+
+                pred = leaf;
+                succ = art_path_after(path, steps);
+
+            } else {
+
+                succ = leaf;
+                pred = art_path_before(path, steps);
+
+            }
+
+            break;
+
+        }
+
+        ArtNode node = (ArtNode) ref;
+        size_t p = 0;
+
+        while (p < node->prefix_len &&
+            node->prefix[p] == art_key_byte(key, depth + p))
+            p++;
+
+        if (p < node->prefix_len) {  // key leaves the prefix
+
+            if (node->prefix[p] < art_key_byte(key, depth + p)) {
+
+                pred = art_maximum(ref);
+                succ = art_path_after(path, steps);
+
+            } else {
+
+                succ = art_minimum(ref);
+                pred = art_path_before(path, steps);
+
+            }
+            // the whole subtree lies to one side of the key
+
+            break;
+
+        }
+
+        depth += node->prefix_len;
+
+        unsigned char c = art_key_byte(key, depth);
+        void ** child = art_find_child(node, c);
+
+        path[steps].node = node;
+        path[steps].c = c;
+        steps++;
+
+        if (child == NULL) {  // both neighbors are beside the missing child
+
+            pred = art_path_before(path, steps);
+            succ = art_path_after(path, steps);
+
+            break;
+
+        }
+
+        ref = *child;
+        depth++;
+
+    }
+
+    if (pred == NULL)
+        return succ;
+
+    if (succ == NULL)
+        return pred;
+
+    return ((pred->key ^ key) <= (succ->key ^ key)) ? pred : succ;
+    // the neighbor sharing the longer prefix is the one a bit trie reaches
+
+}
+
+
+
+/// Lists the children of an inner node in key byte order.
+///
+/// @param node - the inner node
+/// @param out - array of at least RADIX references to fill
+///
+/// @return the number of children
+
+static int art_children(ArtNode node, void ** out) {
+
+    int count = 0;
+
+    switch (node->type) {
+
+        case NODE4:
+            memcpy(out, ((struct Node4_s *) node)->children,
+                node->num_children * sizeof(void *));
+            return node->num_children;
+
+        case NODE16:
+            memcpy(out, ((struct Node16_s *) node)->children,
+                node->num_children * sizeof(void *));
+            return node->num_children;
+
+        case NODE48: {
+
+            struct Node48_s * n = (struct Node48_s *) node;
+
+            for (int i = 0; i < (int) RADIX; i++)
+                if (n->index[i] != 0)
+                    out[count++] = n->children[n->index[i] - 1];
+
+            return count;
+
+        }
+
+        default: {
+
+            struct Node256_s * n = (struct Node256_s *) node;
+
+            for (int i = 0; i < (int) RADIX; i++)
+                if (n->children[i] != NULL)
+                    out[count++] = n->children[i];
+
+            return count;
+
+        }
+
+    }
+
+}
+
+
+
+/// Recursively frees a subtree.
+///
+/// @param art - the Art instance
+/// @param ref - the subtree reference
+
+static void art_destroy_rec(Art art, void * ref) {
+
+    if (IS_LEAF(ref)) {  // frees the entry
+
+        if (art->art_delete_entry != NULL)  // calls user entry free function
+            art->art_delete_entry(LEAF_ENTRY(ref));
+
+        free(LEAF_ENTRY(ref));
+        return;
+
+    }
+
+    void * children[256];
+    int count = art_children((ArtNode) ref, children);
+
+    for (int i = 0; i < count; i++)
+        art_destroy_rec(art, children[i]);
+
+    free(ref);
+
+}
+
+
+
+/// Frees all dynamically allocates memory used in the Art instance.
+
+void art_destroy(Art art) {
+
+    if (art->root != NULL)
+        art_destroy_rec(art, art->root);
+
+    free(art);
+
+}
+
+
+
+/// Fetches the tree size.
+
+size_t art_size(Art art) {
+
+    return art->leaf_nodes;
+
+}
+
+
+
+/// Fetches the number of inner nodes.
+
+size_t art_node_count(Art art) {
+
+    return art->num_nodes;
+
+}
+
+
+
+/// Recursively finds the height of a subtree.
+///
+/// @param ref - the subtree reference
+///
+/// @return height of the subtree
+
+static size_t art_height_rec(void * ref) {
+
+    if (IS_LEAF(ref))
+        return 1;
+
+    void * children[256];
+    int count = art_children((ArtNode) ref, children);
+    size_t height = 0;
+
+    for (int i = 0; i < count; i++) {
+
+        size_t h = art_height_rec(children[i]);
+
+        if (h > height)
+            height = h;
+
+    }
+
+    return height + 1;
+
+}
+
+
+
+/// Computes the tree height.
+
+size_t art_height(Art art) {
+
+    return (art->root == NULL) ? 0 : art_height_rec(art->root);
+
+}
+
+
+
+/// Fetches the bytes used by inner nodes.
+
+size_t art_memory(Art art) {
+
+    return art->node_bytes;
+
+}
+
+
+
+/// Acts as a wrapper for user-passed display function to print an entry.
+
+void art_show_value(Art art, Entry entry, FILE * stream) {
+
+    if (art->art_show_value_w == NULL) {  // handles incorrect ADT usage error
+
+        fprintf(stderr, "error: no user display function defined\n");
+        return;
+
+    }
+
+    art->art_show_value_w(entry, stream);
+
+}
+
+
+
+/// Recursively displays a subtree in key order.
+///
+/// @param art - the Art instance to display
+/// @param ref - the subtree reference
+/// @param stream - the stream where display is output
+
+static void art_show_rec(Art art, void * ref, FILE * stream) {
+
+    if (IS_LEAF(ref)) {  // shows leaf values
+
+        art_show_value(art, LEAF_ENTRY(ref), stream);
+        return;
+
+    }
+
+    void * children[256];
+    int count = art_children((ArtNode) ref, children);
+
+    for (int i = 0; i < count; i++)
+        art_show_rec(art, children[i], stream);
+
+}
+
+
+
+/// Displays tree data.
+
+void art_show(Art art, FILE * stream) {
+
+    if (art->root != NULL)
+        art_show_rec(art, art->root, stream);
+
+}
@@ -0,0 +1,138 @@
+// File: art.h
+//
+// Description: header for an Adaptive Radix Tree (ART) ADT keyed by ikey_t
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef ART_H
+#define ART_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+
+
+
+/// Art is a pointer to the Art ADT.
+typedef struct Art_s * Art;
+
+
+
+/// Create an Art instance and initialize its fields.
+/// Entries and callbacks are the same as for the Trie ADT.
+///
+/// @param ext_show_value - a function pointer that the user passes
+///     to indicate how to display entry key and values properly
+/// @param ext_delete_entry - a function pointer that the user passes
+///     to indicate how values within an entry are freed
+///
+/// @return pointer to the Art object instance or NULL on failure
+
+Art art_create(void (*ext_show_value)(Entry entry, FILE * stream),
+    void (*ext_delete_entry)(Entry entry));
+
+
+
+/// Destroy the tree and free all storage.
+///
+/// @param art - a pointer to an Art instance
+///
+/// @pre art is a valid Art instance pointer
+/// @post the storage associated with the Art and all data has been freed
+
+void art_destroy(Art art);
+
+
+
+/// Insert an entry into the Art as long as the entry is not already present.
+///
+/// @param art - a pointer to an Art instance
+/// @param key - the unique key ID associated with each leaf
+/// @param value - the value entry associated with the leaf
+///
+/// @return 1 if inserted, 0 if the key was already present, -1 if memory
+///     ran out (the tree is unchanged and the value not taken)
+///
+/// @post the tree has grown to include a new entry IFF not already present
+
+int art_insert(Art art, ikey_t key, ival_t value);
+
+
+
+/// Search for the key in the tree by finding the closest entry that
+/// matches key, giving the same answer as ibt_search would.
+///
+/// @param art - a pointer to an Art instance
+/// @param key - the key to find
+///
+/// @return entry representing the found entry
+
+Entry art_search(Art art, ikey_t key);
+
+
+
+/// Get the size of the tree or number of leaf elements.
+///
+/// @param art - a pointer to an Art instance
+///
+/// @return size of tree
+
+size_t art_size(Art art);
+
+
+
+/// Get the node count of the tree: the number of inner nodes.
+///
+/// @param art - a pointer to an Art instance
+///
+/// @return the count of inner nodes
+
+size_t art_node_count(Art art);
+
+
+
+/// Get height of the tree (computed with a traversal).
+///
+/// @param art - a pointer to an Art instance
+///
+/// @return height of tree
+
+size_t art_height(Art art);
+
+
+
+/// Get the bytes used by inner nodes, for comparison with other engines.
+///
+/// @param art - a pointer to an Art instance
+///
+/// @return total size of all inner nodes in bytes
+
+size_t art_memory(Art art);
+
+
+
+/// Displays an individual value in a the tree.
+///
+/// @param art - a pointer to an Art instance
+/// @param entry - structure to hold node data
+/// @param stream - file stream to display data
+
+void art_show_value(Art art, Entry entry, FILE * stream);
+
+
+
+/// Perform an in-order traversal to show each (key, value) in the tree.
+///
+/// @param art - a pointer to an Art instance
+/// @param stream - the stream destination of output
+
+void art_show(Art art, FILE * stream);
+
+
+
+#endif  // ART_H
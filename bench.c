@@ -0,0 +1,408 @@
+// File: bench.c
+//
+// Description: measures trie insert and search speed, and the other lookup
+// engines, on generated or CSV workloads and writes the results as JSON
+//
+// @author: Max Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "engines.h"
+
+
+#define ROWS 1000000
+// synthetic rows when no file is given
+
+
+#define QUERIES 1000000
+// keys in each query stream
+
+
+#define ZIPFS 0.99
+// default Zipf exponent
+
+
+#define USAGE "usage: bench [-n rows] [-q queries] [-s seed] [-z zipf_s] " \
+    "[-o json_file] [-l] [-j] [-r] [-H] [-P] [-L] [-E | -C] [filename]\n"
+// command usage message
+
+
+
+/// Program entry point.
+/// Loads a workload, builds the engines and writes their measurements.
+///
+/// @param argc - number of command line arguments
+/// @param argv - command line arguments
+///
+/// @return EXIT_SUCCESS or EXIT_FAILURE if error occurs
+
+int main(int argc, char * argv[]) {
+
+    size_t rows = 0;
+    size_t queries = QUERIES;
+    unsigned long long seed = 1;
+    double zipf_s = ZIPFS;
+    char * json_name = NULL;
+    char leaf_push = 0;
+    char jump = 0;
+    char relayout = 0;
+    char engines = 1;
+    char check = 0;
+    int arena = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:q:s:z:o:ljrHPLEC")) != -1) {
+
+        switch (opt) {
+
+            case 'n':  // rows to generate, or the most to read from file
+                rows = (size_t) strtoull(optarg, NULL, 10);
+                break;
+
+            case 'q':  // keys in each query stream
+                queries = (size_t) strtoull(optarg, NULL, 10);
+                break;
+
+            case 's':  // seed for rows and query streams
+                seed = strtoull(optarg, NULL, 10);
+                break;
+
+            case 'z':  // skew of the Zipf stream
+                zipf_s = strtod(optarg, NULL);
+                break;
+
+            case 'o':  // write JSON here instead of standard output
+                json_name = optarg;
+                break;
+
+            case 'l':  // leaf-push the trie once loaded
+                leaf_push = 1;
+                break;
+
+            case 'j':  // build the top-level jump table once loaded
+                jump = 1;
+                break;
+
+            case 'r':  // repack nodes after profiling the Zipf stream
+                relayout = 1;
+                break;
+
+            case 'H':  // node and entry storage on 2 MB pages
+                arena |= ARN_HUGETLB;
+                break;
+
+            case 'P':  // prefault node and entry storage
+                arena |= ARN_POPULATE;
+                break;
+
+            case 'L':  // lock node and entry storage in memory
+                arena |= ARN_LOCK;
+                break;
+
+            case 'E':  // measure the trie only
+                engines = 0;
+                break;
+
+            case 'C':  // check every engine's answers instead of timing
+                check = 1;
+                break;
+
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+
+        }
+
+    }
+
+    if (argc - optind > 1 || (check && !engines)) {  // handles usage error
+
+        fprintf(stderr, USAGE);
+        return EXIT_FAILURE;
+
+    }
+
+    FILE * out = stdout;
+
+    if (json_name != NULL && (out = fopen(json_name, "w")) == NULL) {
+
+        perror(json_name);
+        return EXIT_FAILURE;
+
+    }
+
+    Bench bench;
+    memset(&bench, 0, sizeof(Bench));
+    rid_init(&bench.rid);
+    bench.counters = pfc_open();
+
+    if (bench.counters == NULL) {  // handles memory allocation error
+
+        fprintf(stderr, "error: failed to allocate memory for counters\n");
+        return EXIT_FAILURE;
+
+    }
+
+    int available = 0;
+
+    for (int e = 0; e < PFC_EVENTS; e++)  // unavailable counters show null
+        available += pfc_available(bench.counters, e);
+
+    char * filename = (optind < argc) ? argv[optind] : NULL;
+    Workload work;
+    pfc_start(bench.counters);
+    unsigned long long start = wkl_now_ns();
+
+    if (filename != NULL) {  // rows come from a place_ip CSV file
+
+        FILE * fp = fopen(filename, "r");
+
+        if (fp == NULL) {  // handles file error
+
+            perror(filename);
+            return EXIT_FAILURE;
+
+        }
+
+        work = wkl_read_csv(fp, rows);
+        fclose(fp);
+
+    } else {
+
+        work = wkl_synthetic((rows == 0) ? ROWS : rows, seed);
+
+    }
+
+    unsigned long long parse_ns = wkl_now_ns() - start;
+    pfc_stop(bench.counters);
+
+    if (work == NULL || wkl_rows(work) == 0) {  // handles empty workload
+
+        fprintf(stderr, "error: no rows to load\n");
+        return EXIT_FAILURE;
+
+    }
+
+    fprintf(out, "{\n  \"config\": {\"source\": \"%s\", \"rows\": %zu, "
+        "\"queries\": %zu, \"seed\": %llu, \"zipf_s\": %.3f,\n"
+        "    \"leaf_push\": %d, \"jump\": %d, \"relayout\": %d, "
+        "\"arena_flags\": %d, \"counters_available\": %d},\n",
+        (filename != NULL) ? filename : "synthetic", wkl_rows(work), queries,
+        seed, zipf_s, leaf_push, jump, relayout, arena, available);
+
+    fprintf(out, "  \"load\": {\"parse_ns\": %llu,\n    \"parse_per_row\": ",
+        parse_ns);
+    pfc_show(bench.counters, (double) wkl_rows(work), out);
+
+    ikey_t * streams[WKL_STREAMS];
+
+    for (int k = 0; k < WKL_STREAMS; k++) {  // same streams for every engine
+
+        streams[k] = wkl_queries(work, k, queries, zipf_s, seed + k + 1);
+
+        if (streams[k] == NULL) {  // handles memory allocation error
+
+            fprintf(stderr, "error: failed to allocate memory for queries\n");
+            return EXIT_FAILURE;
+
+        }
+
+    }
+
+    size_t rss_before = wkl_rss();
+
+    if (!bench_load_trie(&bench, work, arena)) {  // handles trie error
+
+        fprintf(stderr, "error: failed to allocate memory for trie\n");
+        return EXIT_FAILURE;
+
+    }
+
+    size_t keys = 2 * wkl_rows(work);
+
+    fprintf(out, ",\n    \"insert_ns\": %llu, \"insert_ns_per_op\": %.2f, "
+        "\"inserts_per_sec\": %.0f,\n    \"insert_per_key\": ",
+        bench.build_ns[BENCH_TRIE],
+        (double) bench.build_ns[BENCH_TRIE] / (double) keys,
+        (double) keys * 1e9 / (double) bench.build_ns[BENCH_TRIE]);
+    pfc_show(bench.counters, (double) keys, out);
+    fprintf(out, "},\n");
+
+    if (leaf_push)  // every lookup becomes a fixed root-to-leaf walk
+        ibt_leaf_push(bench.trie);
+
+    if (jump && !ibt_jump_build(bench.trie))  // searches still work without it
+        fprintf(stderr, "error: failed to allocate memory for jump table\n");
+
+    if (relayout)
+        bench_relayout(&bench, streams[WKL_ZIPF], queries);
+
+    size_t rss_trie = wkl_rss();
+
+    if (engines && !bench_build_engines(&bench, work)) {  // handles error
+
+        fprintf(stderr, "error: failed to allocate memory for engines\n");
+        return EXIT_FAILURE;
+
+    }
+
+    size_t huge;
+    size_t mapped = ibt_arena_mapped(bench.trie, &huge);
+
+    fprintf(out, "  \"trie\": {\"size\": %zu, \"node_count\": %zu, "
+        "\"height\": %zu, \"jump_direct\": %zu,\n"
+        "    \"arena_mapped\": %zu, \"arena_huge\": %zu, \"rss_bytes\": %zu, "
+        "\"trie_rss_bytes\": %zu},\n", ibt_size(bench.trie),
+        ibt_node_count(bench.trie), ibt_height(bench.trie),
+        ibt_jump_direct(bench.trie), mapped, huge, rss_trie,
+        (rss_trie > rss_before) ? rss_trie - rss_before : 0);
+
+    if (check) {  // compares answers, then stops
+
+        size_t mismatches[BENCH_ENGINES];
+        size_t checked = bench_check(&bench, work, streams, WKL_STREAMS,
+            queries, mismatches);
+        size_t total = 0;
+
+        fprintf(out, "  \"check\": {\"keys\": %zu, \"mismatches\": {",
+            checked);
+
+        for (int e = 0; e < BENCH_ENGINES; e++) {
+
+            fprintf(out, "%s\"%s\": %zu", (e == 0) ? "" : ", ",
+                BENCH_ENGINE_NAMES[e], mismatches[e]);
+            total += mismatches[e];
+
+        }
+
+        size_t order_wrong = 0;
+        size_t order_checked = bench_check_order(&bench, work, streams,
+            WKL_STREAMS, queries, &order_wrong);
+        // runs last, as its inserts change the trie
+
+        fprintf(out, "},\n    \"order_keys\": %zu, "
+            "\"order_mismatches\": %zu}\n}\n", order_checked, order_wrong);
+
+        if (out != stdout)
+            fclose(out);
+
+        if (total != 0)  // some engine disagrees with the trie
+            fprintf(stderr, "error: %zu answers differ from the trie\n",
+                total);
+
+        if (order_checked == 0)  // handles memory allocation error
+            fprintf(stderr, "error: failed to allocate memory for order "
+                "check\n");
+
+        if (order_wrong != 0)  // rank, select or neighbors are off
+            fprintf(stderr, "error: %zu trie order answers differ from the "
+                "sorted keys\n", order_wrong);
+
+        total += order_wrong + (order_checked == 0);
+
+        for (int k = 0; k < WKL_STREAMS; k++)
+            free(streams[k]);
+
+        pfc_close(bench.counters);
+        bench_destroy(&bench);
+        wkl_destroy(work);
+
+        return (total == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    }
+
+    fprintf(out, "  \"search\": {\n");
+
+    for (int e = 0; e < (engines ? BENCH_ENGINES : 1); e++) {
+
+        fprintf(out, "    \"%s\": {\n", BENCH_ENGINE_NAMES[e]);
+
+        for (int k = 0; k < WKL_STREAMS; k++) {  // ns and counts per lookup
+
+            double ns = bench_time_search(&bench, e, streams[k], queries);
+
+            fprintf(out, "      \"%s\": {\"ns_per_op\": %.2f, "
+                "\"per_lookup\": ", WKL_STREAM_NAMES[k], ns);
+            pfc_show(bench.counters, (double) queries, out);
+            fprintf(out, "}%s\n", (k + 1 < WKL_STREAMS) ? "," : "");
+
+        }
+
+        fprintf(out, "    }%s\n", (e + 1 < (engines ? BENCH_ENGINES : 1)) ?
+            "," : "");
+
+    }
+
+    fprintf(out, "  },\n");
+
+    Entry * answers = (Entry *) malloc(queries * sizeof(Entry));
+    FILE * sink = fopen("/dev/null", "w");
+
+    if (answers != NULL && sink != NULL) {  // formats uniform stream answers
+
+        for (size_t i = 0; i < queries; i++)
+            answers[i] = ibt_search(bench.trie, streams[WKL_UNIFORM][i]);
+
+        double ns = bench_time_show(&bench, answers, queries, sink);
+
+        fprintf(out, "  \"show\": {\"ns_per_op\": %.2f, \"per_entry\": ",
+            ns);
+        pfc_show(bench.counters, (double) queries, out);
+        fprintf(out, "},\n");
+
+    }
+
+    free(answers);
+
+    if (sink != NULL)
+        fclose(sink);
+
+    if (engines) {  // build cost and size of each other engine
+
+        fprintf(out, "  \"engines\": {\n");
+        fprintf(out, "    \"bucket_trie\": {\"build_ns\": %llu, "
+            "\"node_count\": %zu, \"buckets\": %zu, \"height\": %zu},\n",
+            bench.build_ns[BENCH_BUCKET], bkt_node_count(bench.bucket),
+            bkt_bucket_count(bench.bucket), bkt_height(bench.bucket));
+        fprintf(out, "    \"art\": {\"build_ns\": %llu, \"node_count\": %zu, "
+            "\"height\": %zu, \"memory_bytes\": %zu},\n",
+            bench.build_ns[BENCH_ART], art_node_count(bench.art),
+            art_height(bench.art), art_memory(bench.art));
+        fprintf(out, "    \"trie_define\": {\"build_ns\": %llu, "
+            "\"node_count\": %zu, \"height\": %zu},\n",
+            bench.build_ns[BENCH_DEFINE], rid_node_count(&bench.rid),
+            rid_height(&bench.rid));
+        fprintf(out, "    \"lulea\": {\"build_ns\": %llu, "
+            "\"memory_bytes\": %zu},\n", bench.build_ns[BENCH_LULEA],
+            lulea_memory(bench.lulea));
+        fprintf(out, "    \"yfast\": {\"build_ns\": %llu, "
+            "\"memory_bytes\": %zu},\n", bench.build_ns[BENCH_YFAST],
+            yft_memory(bench.yfast));
+        fprintf(out, "    \"elias_fano\": {\"build_ns\": %llu, "
+            "\"memory_bytes\": %zu},\n", bench.build_ns[BENCH_EF],
+            ef_memory(bench.ef));
+        fprintf(out, "    \"bitmap24\": {\"build_ns\": %llu, "
+            "\"memory_bytes\": %zu, \"exceptions\": %zu}\n",
+            bench.build_ns[BENCH_BM24], bm24_memory(bench.bm24),
+            bm24_exception_count(bench.bm24));
+        fprintf(out, "  },\n");
+
+    }
+
+    fprintf(out, "  \"max_rss_bytes\": %zu\n}\n", wkl_max_rss());
+
+    if (out != stdout)
+        fclose(out);
+
+    for (int k = 0; k < WKL_STREAMS; k++)
+        free(streams[k]);
+
+    pfc_close(bench.counters);
+    bench_destroy(&bench);
+    wkl_destroy(work);
+
+    return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,370 @@
+// File: bitmap24.c
+//
+// Description: module for a rank-indexed /24 occupancy bitmap index
+//
+// The 2^24 /24 blocks are grouped into runs of consecutive blocks that
+// map wholly to the same range (or to none). Bit b of a 2 MB bitmap is
+// set when block b starts a run, and a directory holds the count of set
+// bits before every 256-bit line, so the run of block b is
+//
+//     dir[b / 256] + popcount(bitmap bits of b's line up to b) - 1
+//
+// Each run stores its range index. A block that a range boundary splits
+// always starts a run of its own, whose value points at an exception: the
+// block's sorted segment starts (last octet) and their range indices.
+// Data aligned to /24 boundaries produces no exceptions at all.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include <stdint.h>
+
+#include "bitmap24.h"
+
+
+
+#define BLOCKS (1u << 24)
+// number of /24 blocks
+
+
+#define WORDBITS 64
+#define LINEBITS 256
+// bits per bitmap word and per directory entry
+
+
+#define EXCEPTTAG (1u << 31)
+#define NOVALUE   (EXCEPTTAG - 1)
+// run value tags: exception index, or no containing range
+
+
+
+/// Defines the struct for the Bitmap24 ADT
+struct Bitmap24_s {
+
+    uint64_t * bitmap;
+    unsigned int * dir;
+    // run-start bits and the set bits before each line
+
+    unsigned int * runs;
+    size_t num_runs;
+    size_t run_cap;
+    // range index, NOVALUE or exception index | EXCEPTTAG per run
+
+    unsigned int * except_first;
+    size_t num_excepts;
+    size_t except_cap;
+    // first segment of each exception, plus a final end marker
+
+    unsigned char * seg_lo;
+    unsigned int * seg_val;
+    size_t num_segs;
+    size_t seg_cap;
+    // segment starts (last octet) and range index or NOVALUE
+
+};
+
+
+
+/// Grows a dynamic array to hold at least need elements.
+///
+/// @param array - the array (passed as pointer)
+/// @param cap - the capacity (passed as pointer)
+/// @param need - the required element count
+/// @param size - the element size
+///
+/// @return 1 on success, 0 on memory error (array and capacity unchanged)
+
+static int bm24_reserve(void ** array, size_t * cap, size_t need,
+    size_t size) {
+
+    if (need <= *cap)
+        return 1;
+
+    size_t grown = *cap;
+
+    while (grown < need)
+        grown = (grown == 0) ? 1024 : grown * 2;
+
+    void * block = realloc(*array, grown * size);
+
+    if (block == NULL)  // handles memory error, keeps the old block
+        return 0;
+
+    *array = block;
+    *cap = grown;
+
+    return 1;
+
+}
+
+
+
+/// Counts the set bits of a word.
+///
+/// @param word - the word
+///
+/// @return the number of set bits
+
+static unsigned int bm24_popcount(uint64_t word) {
+
+#ifdef __GNUC__
+
+    return (unsigned int) __builtin_popcountll(word);
+
+#else
+
+    unsigned int count = 0;
+
+    for (; word != 0; word &= word - 1)
+        count++;
+
+    return count;
+
+#endif
+
+}
+
+
+
+/// Appends one segment to the exception being built.
+///
+/// @param index - the Bitmap24 instance
+/// @param lo - the segment's first key
+/// @param value - the range index or NOVALUE
+///
+/// @return 1 on success, 0 on memory error
+
+static int bm24_add_segment(Bitmap24 index, unsigned long long lo,
+    unsigned int value) {
+
+    size_t seg_cap = index->seg_cap;
+
+    if (!bm24_reserve((void **) &index->seg_val, &seg_cap,
+        index->num_segs + 1, sizeof(unsigned int)) ||
+        !bm24_reserve((void **) &index->seg_lo, &index->seg_cap,
+        index->num_segs + 1, sizeof(unsigned char)))
+        return 0;
+    // both arrays share one capacity, recorded once both have grown
+
+    index->seg_lo[index->num_segs] = (unsigned char) (lo & 0xff);
+    index->seg_val[index->num_segs] = value;
+    index->num_segs++;
+
+    return 1;
+
+}
+
+
+
+/// Frees all storage used by the index.
+
+void bm24_destroy(Bitmap24 index) {
+
+    free(index->bitmap);
+    free(index->dir);
+    free(index->runs);
+    free(index->except_first);
+    free(index->seg_lo);
+    free(index->seg_val);
+    free(index);
+
+}
+
+
+
+/// Builds the index from normalized ranges.
+
+Bitmap24 bm24_build(Ranges ranges) {
+
+    Bitmap24 index = (Bitmap24) calloc(1, sizeof(struct Bitmap24_s));
+
+    if (index == NULL)  // signifies an allocation failure
+        return NULL;
+
+    index->bitmap = (uint64_t *) calloc(BLOCKS / WORDBITS, sizeof(uint64_t));
+    index->dir = (unsigned int *) malloc(BLOCKS / LINEBITS *
+        sizeof(unsigned int));
+
+    if (index->bitmap == NULL || index->dir == NULL) {  // allocation failure
+
+        bm24_destroy(index);
+        return NULL;
+
+    }
+
+    struct Range_s * items = rng_items(ranges);
+    size_t count = rng_count(ranges);
+    size_t r = 0;
+    // first range not wholly below the current block
+
+    unsigned int prev = EXCEPTTAG;
+    // value of the previous block (EXCEPTTAG never equals a block value)
+
+    for (unsigned long long b = 0; b < BLOCKS; b++) {  // classifies blocks
+
+        unsigned long long lo = b << 8;
+        unsigned long long hi = lo + 255;
+
+        while (r < count && items[r].hi < lo)
+            r++;
+
+        unsigned int value;
+
+        if (r == count || items[r].lo > hi)  // no range touches the block
+            value = NOVALUE;
+
+        else if (items[r].lo <= lo && items[r].hi >= hi)  // one range covers it
+            value = (unsigned int) r;
+
+        else {  // split block becomes an exception
+
+            if (!bm24_reserve((void **) &index->except_first,
+                &index->except_cap, index->num_excepts + 2,
+                sizeof(unsigned int))) {  // handles memory error
+
+                bm24_destroy(index);
+                return NULL;
+
+            }
+
+            value = (unsigned int) index->num_excepts | EXCEPTTAG;
+            index->except_first[index->num_excepts++] =
+                (unsigned int) index->num_segs;
+
+            unsigned long long pos = lo;
+            size_t j = r;
+
+            while (pos <= hi) {  // cuts the block into segments
+
+                char added;
+
+                if (j < count && items[j].lo <= pos) {  // inside range j
+
+                    added = bm24_add_segment(index, pos, (unsigned int) j);
+                    pos = (unsigned long long) items[j].hi + 1;
+                    j++;
+
+                }
+
+                else {  // gap up to the next range or the block's end
+
+                    added = bm24_add_segment(index, pos, NOVALUE);
+                    pos = (j < count && items[j].lo <= hi) ?
+                        items[j].lo : hi + 1;
+
+                }
+
+                if (!added) {  // handles memory error
+
+                    bm24_destroy(index);
+                    return NULL;
+
+                }
+
+            }
+
+        }
+
+        if (value != prev || (value & EXCEPTTAG)) {  // starts a new run
+
+            if (!bm24_reserve((void **) &index->runs, &index->run_cap,
+                index->num_runs + 1, sizeof(unsigned int))) {
+
+                bm24_destroy(index);
+                return NULL;
+
+            }
+            // handles memory error
+
+            index->runs[index->num_runs++] = value;
+            index->bitmap[b / WORDBITS] |= 1ULL << (b % WORDBITS);
+
+        }
+
+        prev = value;
+
+    }
+
+    if (index->except_first != NULL)  // closes the last exception
+        index->except_first[index->num_excepts] =
+            (unsigned int) index->num_segs;
+
+    unsigned int total = 0;
+
+    for (size_t line = 0; line < BLOCKS / LINEBITS; line++) {  // fills dir
+
+        index->dir[line] = total;
+
+        for (size_t w = 0; w < LINEBITS / WORDBITS; w++)
+            total += bm24_popcount(
+                index->bitmap[line * (LINEBITS / WORDBITS) + w]);
+
+    }
+
+    return index;
+
+}
+
+
+
+/// Finds the containing range through the block's run.
+
+size_t bm24_lookup(Bitmap24 index, ikey_t key) {
+
+    size_t b = key >> 8;
+    size_t word = b / WORDBITS;
+
+    unsigned int rank = index->dir[b / LINEBITS];
+
+    for (size_t w = word & ~(size_t) (LINEBITS / WORDBITS - 1); w < word; w++)
+        rank += bm24_popcount(index->bitmap[w]);
+    // counts run starts earlier in the line
+
+    rank += bm24_popcount(index->bitmap[word] &
+        (~0ULL >> (WORDBITS - 1 - b % WORDBITS)));
+
+    unsigned int value = index->runs[rank - 1];
+
+    if (value & EXCEPTTAG) {  // split block: finds the last segment start
+
+        size_t e = value & ~EXCEPTTAG;
+        size_t s = index->except_first[e];
+        size_t end = index->except_first[e + 1];
+        unsigned char low = (unsigned char) (key & 0xff);
+
+        while (s + 1 < end && index->seg_lo[s + 1] <= low)
+            s++;
+
+        value = index->seg_val[s];
+
+    }
+
+    return (value == NOVALUE) ? RNG_NONE : value;
+
+}
+
+
+
+/// Fetches the exception count.
+
+size_t bm24_exception_count(Bitmap24 index) {
+
+    return index->num_excepts;
+
+}
+
+
+
+/// Computes the bytes used by the index.
+
+size_t bm24_memory(Bitmap24 index) {
+
+    return BLOCKS / 8 + BLOCKS / LINEBITS * sizeof(unsigned int) +
+        index->num_runs * sizeof(unsigned int) +
+        (index->num_excepts + 1) * sizeof(unsigned int) +
+        index->num_segs * (sizeof(unsigned char) + sizeof(unsigned int));
+
+}
@@ -0,0 +1,80 @@
+// File: bitmap24.h
+//
+// Description: header for a rank-indexed /24 occupancy bitmap index
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef BITMAP24_H
+#define BITMAP24_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+#include "ranges.h"
+
+
+
+/// Bitmap24 is a pointer to the Bitmap24 ADT.
+typedef struct Bitmap24_s * Bitmap24;
+
+
+
+/// Build a read-only index with one bit per /24 block, set where a new
+/// run of blocks with the same answer begins, and a rank directory over
+/// the bits. Blocks that a range boundary splits are resolved through a
+/// small exception table.
+///
+/// @param ranges - a pointer to a normalized Ranges instance
+///     (at most 2^31 - 2 ranges)
+///
+/// @return pointer to the Bitmap24 instance or NULL on failure
+
+Bitmap24 bm24_build(Ranges ranges);
+
+
+
+/// Destroy the index and free all storage (the Ranges are not touched).
+///
+/// @param index - a pointer to a Bitmap24 instance
+
+void bm24_destroy(Bitmap24 index);
+
+
+
+/// Find the range containing key with one bitmap read and a popcount.
+///
+/// @param index - a pointer to a Bitmap24 instance
+/// @param key - the key to find
+///
+/// @return the index of the containing range or RNG_NONE
+
+size_t bm24_lookup(Bitmap24 index, ikey_t key);
+
+
+
+/// Get the number of /24 blocks split by a range boundary.
+///
+/// @param index - a pointer to a Bitmap24 instance
+///
+/// @return the exception count
+
+size_t bm24_exception_count(Bitmap24 index);
+
+
+
+/// Get the bytes used by the index.
+///
+/// @param index - a pointer to a Bitmap24 instance
+///
+/// @return total size of the bitmap, directory, runs and exceptions
+
+size_t bm24_memory(Bitmap24 index);
+
+
+
+#endif  // BITMAP24_H
@@ -0,0 +1,459 @@
+// File: bucket_trie.c
+//
+// Description: module for a read-only, path-compressed trie whose bottom
+// levels are replaced by small sorted key buckets
+//
+// The entries of the source trie are copied out in key order. Internal
+// nodes split on the first bit in which their key range differs, and any
+// range of at most BUCKETKEYS keys becomes a bucket: one 64-byte block of
+// sorted keys. A bucket search counts the keys not above the query with a
+// vector compare and popcount, which gives the query's position in the
+// global key order; the closest match is then whichever neighbor shares
+// the longer prefix with the query, exactly as ibt_search decides.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#define _DEFAULT_SOURCE
+// exposes posix_memalign
+
+#include "bucket_trie.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+
+#define LEAFTAG (1u << 31)
+// tags a child index as a bucket index rather than a node index
+
+
+#define CACHELINE 64
+// bucket alignment
+
+
+
+/// Bucket_s holds the sorted keys of one small subtree in a cache line.
+struct Bucket_s {
+
+    ikey_t keys[16];
+
+};
+
+
+
+/// BNode_s is an internal node testing a single bit.
+struct BNode_s {
+
+    ikey_t prefix;
+    // common leading bits of every key below (remaining bits zero)
+
+    unsigned int bit;
+    // bit tested, counted from the most significant bit
+
+    unsigned int child[2];
+    // node index, or bucket index | LEAFTAG
+
+    unsigned int base;
+    unsigned int end;
+    // global positions of the first and one past the last key below
+
+};
+
+
+
+/// Defines the struct for the BucketTrie ADT
+struct BucketTrie_s {
+
+    ikey_t * keys;
+    Entry * entries;
+    size_t size;
+    // every key and entry in key order
+
+    struct BNode_s * nodes;
+    size_t num_nodes;
+    // internal nodes
+
+    struct Bucket_s * buckets;
+    unsigned int * bucket_base;
+    unsigned int * bucket_count;
+    size_t num_buckets;
+    // bucket keys (cache-line aligned) and their global position and size
+
+    unsigned int root;
+    size_t height;
+
+};
+
+
+
+const size_t BUCKETKEYS = 16;        /// < maximum keys held in a bucket
+
+
+
+/// Finds the first bit in which two different keys differ.
+///
+/// @param a - the first key
+/// @param b - the second key
+///
+/// @return the bit index, counted from the most significant bit
+
+static unsigned int bkt_crit_bit(ikey_t a, ikey_t b) {
+
+    ikey_t mask = 1;
+    mask <<= (BITSPERWORD - 1);
+
+    unsigned int bit = 0;
+
+    while (((a ^ b) & mask) == 0) {
+
+        mask >>= 1;
+        bit++;
+
+    }
+
+    return bit;
+
+}
+
+
+
+/// Counts the nodes and buckets needed for a sorted key range.
+///
+/// @param keys - the sorted keys
+/// @param lo - the first position of the range
+/// @param hi - one past the last position of the range
+/// @param nc - node count (passed as pointer)
+/// @param bc - bucket count (passed as pointer)
+
+static void bkt_count_rec(ikey_t * keys, size_t lo, size_t hi, size_t * nc,
+    size_t * bc) {
+
+    if (hi - lo <= BUCKETKEYS) {  // range fits in a bucket
+
+        (*bc)++;
+        return;
+
+    }
+
+    ikey_t mask = 1;
+    mask <<= (BITSPERWORD - 1 - bkt_crit_bit(keys[lo], keys[hi - 1]));
+
+    size_t mid = lo;
+
+    while ((keys[mid] & mask) == 0)  // finds the first key with the bit set
+        mid++;
+
+    (*nc)++;
+    bkt_count_rec(keys, lo, mid, nc, bc);
+    bkt_count_rec(keys, mid, hi, nc, bc);
+
+}
+
+
+
+/// Recursively builds the nodes and buckets for a sorted key range.
+///
+/// @param btrie - the BucketTrie instance
+/// @param lo - the first position of the range
+/// @param hi - one past the last position of the range
+/// @param depth - depth of the subtree root
+///
+/// @return node index, or bucket index | LEAFTAG
+
+static unsigned int bkt_build_rec(BucketTrie btrie, size_t lo, size_t hi,
+    size_t depth) {
+
+    if (hi - lo <= BUCKETKEYS) {  // range fits in a bucket
+
+        size_t b = btrie->num_buckets++;
+
+        for (size_t i = 0; i < BUCKETKEYS; i++)  // pads with the largest key
+            btrie->buckets[b].keys[i] = (lo + i < hi) ?
+                btrie->keys[lo + i] : (ikey_t) -1;
+
+        btrie->bucket_base[b] = (unsigned int) lo;
+        btrie->bucket_count[b] = (unsigned int) (hi - lo);
+
+        if (depth > btrie->height)
+            btrie->height = depth;
+
+        return (unsigned int) b | LEAFTAG;
+
+    }
+
+    unsigned int bit = bkt_crit_bit(btrie->keys[lo], btrie->keys[hi - 1]);
+
+    ikey_t mask = 1;
+    mask <<= (BITSPERWORD - 1 - bit);
+
+    size_t mid = lo;
+
+    while ((btrie->keys[mid] & mask) == 0)  // finds the first key with bit set
+        mid++;
+
+    size_t n = btrie->num_nodes++;
+    struct BNode_s * node = &btrie->nodes[n];
+
+    node->bit = bit;
+    node->prefix = (bit == 0) ? 0 : btrie->keys[lo] & ~((mask << 1) - 1);
+    node->base = (unsigned int) lo;
+    node->end = (unsigned int) hi;
+
+    node->child[0] = bkt_build_rec(btrie, lo, mid, depth + 1);
+    node->child[1] = bkt_build_rec(btrie, mid, hi, depth + 1);
+    // node array is sized up front, so node stays valid during recursion
+
+    return (unsigned int) n;
+
+}
+
+
+
+/// Builds a bucket trie from the entries of a Trie.
+
+BucketTrie bkt_build(Trie trie) {
+
+    size_t size = ibt_size(trie);
+
+    if (size == 0)  // nothing to index
+        return NULL;
+
+    BucketTrie btrie = (BucketTrie) malloc(sizeof(struct BucketTrie_s));
+
+    if (btrie == NULL)  // signifies an allocation failure
+        return NULL;
+
+    btrie->size = size;
+    btrie->keys = (ikey_t *) malloc(size * sizeof(ikey_t));
+    btrie->entries = (Entry *) malloc(size * sizeof(Entry));
+    btrie->nodes = NULL;
+    btrie->buckets = NULL;
+    btrie->bucket_base = NULL;
+    btrie->bucket_count = NULL;
+
+    if (btrie->keys == NULL || btrie->entries == NULL) {  // allocation failure
+
+        bkt_destroy(btrie);
+        return NULL;
+
+    }
+
+    Iter iter;
+    size_t i = 0;
+
+    for (Entry e = ibt_iter_seek(trie, &iter, 0); e != NULL;
+        e = ibt_iter_next(&iter)) {  // copies entries out in key order
+
+        btrie->keys[i] = e->key;
+        btrie->entries[i] = e;
+        i++;
+
+    }
+
+    size_t nc = 0;
+    size_t bc = 0;
+    bkt_count_rec(btrie->keys, 0, size, &nc, &bc);
+
+    btrie->nodes = (struct BNode_s *) malloc((nc + 1) * sizeof(struct BNode_s));
+    btrie->bucket_base = (unsigned int *) malloc(bc * sizeof(unsigned int));
+    btrie->bucket_count = (unsigned int *) malloc(bc * sizeof(unsigned int));
+
+    if (posix_memalign((void **) &btrie->buckets, CACHELINE,
+        bc * sizeof(struct Bucket_s)) != 0)
+        btrie->buckets = NULL;
+
+    if (btrie->nodes == NULL || btrie->bucket_base == NULL ||
+        btrie->bucket_count == NULL || btrie->buckets == NULL) {
+
+        bkt_destroy(btrie);
+        return NULL;
+
+    }
+    // handles allocation failures
+
+    btrie->num_nodes = 0;
+    btrie->num_buckets = 0;
+    btrie->height = 0;
+    btrie->root = bkt_build_rec(btrie, 0, size, 1);
+
+    return btrie;
+
+}
+
+
+
+/// Frees all memory owned by the bucket trie.
+
+void bkt_destroy(BucketTrie btrie) {
+
+    free(btrie->keys);
+    free(btrie->entries);
+    free(btrie->nodes);
+    free(btrie->buckets);
+    free(btrie->bucket_base);
+    free(btrie->bucket_count);
+    free(btrie);
+
+}
+
+
+
+/// Counts the keys of a bucket that are not above a query key.
+///
+/// @param bucket - the bucket to search
+/// @param count - the number of real (non-padding) keys in the bucket
+/// @param key - the query key
+///
+/// @return the number of bucket keys less than or equal to key
+
+static unsigned int bkt_bucket_rank(struct Bucket_s * bucket,
+    unsigned int count, ikey_t key) {
+
+    unsigned int above;
+
+#ifdef __SSE2__
+
+    const __m128i flip = _mm_set1_epi32((int) 0x80000000u);
+    __m128i q = _mm_xor_si128(_mm_set1_epi32((int) key), flip);
+    // flips sign bits so the signed compare orders unsigned keys
+
+    above = 0;
+
+    for (int i = 0; i < 4; i++) {  // four 4-key compares cover the line
+
+        __m128i k = _mm_xor_si128(
+            _mm_load_si128((__m128i *) bucket->keys + i), flip);
+
+        above |= (unsigned int) _mm_movemask_ps(
+            _mm_castsi128_ps(_mm_cmpgt_epi32(k, q))) << (4 * i);
+
+    }
+
+#else
+
+    above = 0;
+
+    for (unsigned int i = 0; i < BUCKETKEYS; i++)  // scalar fallback
+        above |= (unsigned int) (bucket->keys[i] > key) << i;
+
+#endif
+
+    unsigned int not_above = ~above & ((1u << count) - 1);
+
+#ifdef __GNUC__
+
+    return (unsigned int) __builtin_popcount(not_above);
+
+#else
+
+    unsigned int rank = 0;
+
+    for (; not_above != 0; not_above &= not_above - 1)
+        rank++;
+
+    return rank;
+
+#endif
+
+}
+
+
+
+/// Searches the bucket trie for the closest match to a key.
+
+Entry bkt_search(BucketTrie btrie, ikey_t key) {
+
+    unsigned int cur = btrie->root;
+    size_t pos;
+    // number of keys not above the query key
+
+    while (1) {  // descent loop
+
+        if (cur & LEAFTAG) {  // bucket reached
+
+            unsigned int b = cur & ~LEAFTAG;
+
+            pos = btrie->bucket_base[b] + bkt_bucket_rank(&btrie->buckets[b],
+                btrie->bucket_count[b], key);
+
+            break;
+
+        }
+
+        struct BNode_s * node = &btrie->nodes[cur];
+
+        if (node->bit != 0 &&
+            (key ^ node->prefix) >> (BITSPERWORD - node->bit) != 0) {
+
+            pos = (key < node->prefix) ? node->base : node->end;
+            break;
+
+        }
+        // query leaves the subtree's prefix, so it lies wholly to one side
+
+        ikey_t mask = 1;
+        mask <<= (BITSPERWORD - 1 - node->bit);
+
+        cur = node->child[(key & mask) != 0];
+
+    }
+
+    if (pos == 0)  // no predecessor
+        return btrie->entries[0];
+
+    if (pos == btrie->size)  // no successor
+        return btrie->entries[pos - 1];
+
+    ikey_t pred = btrie->keys[pos - 1];
+    ikey_t succ = btrie->keys[pos];
+
+    return ((pred ^ key) <= (succ ^ key)) ? btrie->entries[pos - 1] :
+        btrie->entries[pos];
+    // the neighbor sharing the longer prefix is the one the trie reaches
+
+}
+
+
+
+/// Fetches the bucket trie size.
+
+size_t bkt_size(BucketTrie btrie) {
+
+    return btrie->size;
+
+}
+
+
+
+/// Fetches the internal node count.
+
+size_t bkt_node_count(BucketTrie btrie) {
+
+    return btrie->num_nodes;
+
+}
+
+
+
+/// Fetches the bucket count.
+
+size_t bkt_bucket_count(BucketTrie btrie) {
+
+    return btrie->num_buckets;
+
+}
+
+
+
+/// Fetches the bucket trie height.
+
+size_t bkt_height(BucketTrie btrie) {
+
+    return btrie->height;
+
+}
@@ -0,0 +1,103 @@
+// File: bucket_trie.h
+//
+// Description: header for a read-only trie with bucketized leaves
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef BUCKET_TRIE_H
+#define BUCKET_TRIE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+
+
+
+/// BucketTrie is a pointer to the BucketTrie ADT.
+typedef struct BucketTrie_s * BucketTrie;
+
+
+
+extern const size_t BUCKETKEYS;         /// < maximum keys held in a bucket
+
+
+
+/// Build a bucket trie holding every entry of a Trie.
+/// Subtrees of at most BUCKETKEYS keys are stored as one cache-line bucket
+/// of sorted keys, searched with a single vector compare and popcount.
+/// The entries are shared with the source Trie, which must outlive it.
+///
+/// @param trie - a pointer to a non-empty Trie instance
+///
+/// @return pointer to the BucketTrie instance or NULL on failure
+
+BucketTrie bkt_build(Trie trie);
+
+
+
+/// Destroy the bucket trie (but not the entries it shares).
+///
+/// @param btrie - a pointer to a BucketTrie instance
+
+void bkt_destroy(BucketTrie btrie);
+
+
+
+/// Search for the closest entry that matches key, giving the same answer
+/// as ibt_search on the source Trie.
+///
+/// @param btrie - a pointer to a BucketTrie instance
+/// @param key - the key to find
+///
+/// @return the closest matching entry
+
+Entry bkt_search(BucketTrie btrie, ikey_t key);
+
+
+
+/// Get the number of entries in the bucket trie.
+///
+/// @param btrie - a pointer to a BucketTrie instance
+///
+/// @return size of the bucket trie
+
+size_t bkt_size(BucketTrie btrie);
+
+
+
+/// Get the number of internal (non-bucket) nodes.
+///
+/// @param btrie - a pointer to a BucketTrie instance
+///
+/// @return the count of internal nodes
+
+size_t bkt_node_count(BucketTrie btrie);
+
+
+
+/// Get the number of buckets.
+///
+/// @param btrie - a pointer to a BucketTrie instance
+///
+/// @return the count of buckets
+
+size_t bkt_bucket_count(BucketTrie btrie);
+
+
+
+/// Get the height of the bucket trie, counting the bucket level.
+///
+/// @param btrie - a pointer to a BucketTrie instance
+///
+/// @return height of the bucket trie
+
+size_t bkt_height(BucketTrie btrie);
+
+
+
+#endif  // BUCKET_TRIE_H
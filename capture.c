@@ -0,0 +1,295 @@
+// File: capture.c
+//
+// Description: module for query capture files
+//
+// A capture is an 8-byte magic followed by one record per query: the
+// microseconds since the previous query as a LEB128 varint (one byte for
+// gaps under 128 us) and the 4-byte key, least significant byte first.
+// Back-to-back queries thus cost 5 bytes each, and the file reads the
+// same on any host byte order.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#define _DEFAULT_SOURCE
+// exposes clock_gettime
+
+#include <string.h>
+#include <time.h>
+
+#include "capture.h"
+
+
+
+#define MAGIC "IBTCAP1"
+// file header, with its terminating zero byte
+
+#define MAGICLEN 8
+// header length
+
+
+
+/// Defines the struct for the Capture ADT
+struct Capture_s {
+
+    FILE * fp;
+    char * buffer;
+    // output file and its preallocated stdio buffer
+
+    unsigned long long last_us;
+    // time of the previous record
+
+    size_t count;
+
+};
+
+
+
+const size_t CAP_BUFFER = 64 * 1024;
+
+
+
+/// Reads the monotonic clock in microseconds.
+///
+/// @return microseconds since an arbitrary fixed point
+
+static unsigned long long cap_now_us(void) {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (unsigned long long) ts.tv_sec * 1000000ULL +
+        (unsigned long long) ts.tv_nsec / 1000;
+
+}
+
+
+
+/// Creates a capture file.
+
+Capture cap_create(const char * filename) {
+
+    Capture capture = (Capture) malloc(sizeof(struct Capture_s));
+
+    if (capture == NULL)  // signifies an allocation failure
+        return NULL;
+
+    capture->fp = fopen(filename, "wb");
+    capture->buffer = (char *) malloc(CAP_BUFFER);
+
+    if (capture->fp == NULL || capture->buffer == NULL ||
+        setvbuf(capture->fp, capture->buffer, _IOFBF, CAP_BUFFER) != 0 ||
+        fwrite(MAGIC, 1, MAGICLEN, capture->fp) != MAGICLEN) {
+
+        if (capture->fp != NULL)
+            fclose(capture->fp);
+
+        free(capture->buffer);
+        free(capture);
+
+        return NULL;
+
+    }
+    // handles file and allocation errors
+
+    capture->last_us = cap_now_us();
+    capture->count = 0;
+
+    return capture;
+
+}
+
+
+
+/// Appends one record.
+
+void cap_record(Capture capture, ikey_t key) {
+
+    unsigned long long now = cap_now_us();
+    unsigned long long gap = now - capture->last_us;
+
+    capture->last_us = now;
+
+    while (gap >= 0x80) {  // seven bits per byte, high bit marks more
+
+        putc((int) (gap & 0x7f) | 0x80, capture->fp);
+        gap >>= 7;
+
+    }
+
+    putc((int) gap, capture->fp);
+
+    for (size_t i = 0; i < BYTESPERWORD; i++)  // least significant first
+        putc((int) ((key >> (BITSPERBYTE * i)) & 0xff), capture->fp);
+
+    capture->count++;
+
+}
+
+
+
+/// Fetches the record count.
+
+size_t cap_count(Capture capture) {
+
+    return capture->count;
+
+}
+
+
+
+/// Closes the capture file.
+
+int cap_close(Capture capture) {
+
+    int ok = !ferror(capture->fp);
+
+    if (fclose(capture->fp) != 0)  // final flush failed
+        ok = 0;
+
+    free(capture->buffer);
+    free(capture);
+
+    return ok;
+
+}
+
+
+
+/// Reads one record.
+///
+/// @param fp - the capture file
+/// @param gap_us - receives the gap before the query (passed as pointer)
+/// @param key - receives the key (passed as pointer)
+///
+/// @return 1 on success, 0 at the end of the file, -1 on a truncated or
+///     malformed record
+
+static int cap_read_record(FILE * fp, unsigned long long * gap_us,
+    ikey_t * key) {
+
+    unsigned long long gap = 0;
+    unsigned int shift = 0;
+    int c = getc(fp);
+
+    if (c == EOF)  // clean end between records
+        return 0;
+
+    while (1) {  // varint gap
+
+        gap |= (unsigned long long) (c & 0x7f) << shift;
+        shift += 7;
+
+        if (!(c & 0x80))
+            break;
+
+        if ((c = getc(fp)) == EOF || shift > 63)
+            return -1;
+
+    }
+
+    ikey_t k = 0;
+
+    for (size_t i = 0; i < BYTESPERWORD; i++) {  // least significant first
+
+        if ((c = getc(fp)) == EOF)
+            return -1;
+
+        k |= (ikey_t) c << (BITSPERBYTE * i);
+
+    }
+
+    *gap_us = gap;
+    *key = k;
+
+    return 1;
+
+}
+
+
+
+/// Loads a capture file into arrays.
+
+int cap_load(const char * filename, ikey_t ** keys,
+    unsigned long long ** at_ns, size_t * count) {
+
+    FILE * fp = fopen(filename, "rb");
+
+    if (fp == NULL)  // handles file error
+        return 0;
+
+    char magic[MAGICLEN];
+
+    if (fread(magic, 1, MAGICLEN, fp) != MAGICLEN ||
+        memcmp(magic, MAGIC, MAGICLEN) != 0) {  // not a capture file
+
+        fclose(fp);
+        return 0;
+
+    }
+
+    size_t n = 0;
+    size_t cap = 1024;
+    unsigned long long gap;
+    unsigned long long now = 0;
+    ikey_t key;
+    int status = -1;
+
+    *keys = (ikey_t *) malloc(cap * sizeof(ikey_t));
+    *at_ns = (unsigned long long *) malloc(cap * sizeof(unsigned long long));
+
+    while (*keys != NULL && *at_ns != NULL &&
+        (status = cap_read_record(fp, &gap, &key)) == 1) {
+
+        if (n == cap) {  // grows both arrays
+
+            cap *= 2;
+
+            ikey_t * nk = (ikey_t *) realloc(*keys, cap * sizeof(ikey_t));
+
+            if (nk != NULL)
+                *keys = nk;
+
+            unsigned long long * nt = (unsigned long long *) realloc(*at_ns,
+                cap * sizeof(unsigned long long));
+
+            if (nt != NULL)
+                *at_ns = nt;
+
+            if (nk == NULL || nt == NULL) {  // handles allocation failure
+
+                status = -1;
+                break;
+
+            }
+
+        }
+
+        now += gap * 1000;
+        (*keys)[n] = key;
+        (*at_ns)[n] = now;
+        n++;
+
+    }
+
+    fclose(fp);
+
+    if (status != 0) {  // handles truncated file or allocation failure
+
+        free(*keys);
+        free(*at_ns);
+        *keys = NULL;
+        *at_ns = NULL;
+
+        return 0;
+
+    }
+
+    *count = n;
+
+    return 1;
+
+}
@@ -0,0 +1,89 @@
+// File: capture.h
+//
+// Description: header for a compact binary log of query keys and their
+// arrival times, written while serving and read back for replay
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+
+
+
+/// Capture is a pointer to the Capture ADT.
+typedef struct Capture_s * Capture;
+
+
+
+extern const size_t CAP_BUFFER;         /// < bytes buffered before a write
+
+
+
+/// Create a capture file and write its header. All memory the capture
+/// needs is allocated here, so recording never allocates.
+///
+/// @param filename - the file to create (truncated if present)
+///
+/// @return pointer to the Capture instance or NULL on failure
+
+Capture cap_create(const char * filename);
+
+
+
+/// Record one query key with the time since the previous record (or
+/// since cap_create, for the first). Each record is the microsecond gap as
+/// a LEB128 varint followed by the 4 key bytes, least significant first.
+///
+/// @param capture - a pointer to a Capture instance
+/// @param key - the query key
+
+void cap_record(Capture capture, ikey_t key);
+
+
+
+/// Get the number of keys recorded.
+///
+/// @param capture - a pointer to a Capture instance
+///
+/// @return the record count
+
+size_t cap_count(Capture capture);
+
+
+
+/// Flush and close the capture file and free the capture.
+///
+/// @param capture - a pointer to a Capture instance
+///
+/// @return 1 if every record reached the file, else 0
+
+int cap_close(Capture capture);
+
+
+
+/// Read a whole capture file into memory.
+///
+/// @param filename - the capture file
+/// @param keys - receives the array of keys (freed by the caller)
+/// @param at_ns - receives the array of arrival times in nanoseconds after
+///     the capture started (freed by the caller)
+/// @param count - receives the number of records
+///
+/// @return 1 on success, 0 on a missing, truncated or foreign file or
+///     allocation failure
+
+int cap_load(const char * filename, ikey_t ** keys,
+    unsigned long long ** at_ns, size_t * count);
+
+
+
+#endif  // CAPTURE_H
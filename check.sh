@@ -0,0 +1,57 @@
+#!/bin/sh
+# File: check.sh
+#
+# Description: builds the tools into a scratch directory and runs their
+# self-checks; exits non-zero if any check fails
+#
+# @author Maximus Milazzo (mam9563@rit.edu)
+#
+###########################################################
+
+set -e
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+gcc -O2 -std=c99 -pthread -o "$dir/bench" bench.c engines.c workload.c \
+    perf_counters.c trie.c arena.c bucket_trie.c art.c ranges.c lulea.c \
+    yfast.c elias_fano.c bitmap24.c -lm
+
+# every engine answers as the trie does, and the trie's rank, select,
+# predecessor and successor match its sorted keys (bench -C)
+"$dir/bench" -C -q 100000 -o /dev/null DATA.csv
+"$dir/bench" -C -n 1 -q 100000 -o /dev/null
+"$dir/bench" -C -n 100000 -q 100000 -o /dev/null
+"$dir/bench" -C -n 100000 -q 100000 -l -j -o /dev/null
+"$dir/bench" -C -n 100000 -q 100000 -l -j -r -o /dev/null
+
+gcc -O2 -std=c99 -pthread -DALC_INTERPOSE -o "$dir/place_ip" place_ip.c \
+    trie.c trie6.c arena.c stride.c lazy_trie.c staged.c capture.c \
+    alloc_count.c
+gcc -O2 -std=c99 -o "$dir/gen_geoip" gen_geoip.c workload.c trie.c arena.c \
+    -lm
+"$dir/gen_geoip" -n 100000 -v 10 -r r "$dir/rows.csv"
+
+cat > "$dir/queries.txt" << EOF
+55.3
+55.3.22.12
+5.94.39.7
+16817663
+90.56.0.0/16
+::ffff:5.94.39.7
+0.0.0.0
+255.255.255.255
+not an address
+
+EOF
+
+# the -D query loop makes no allocator calls (query_allocations: 0)
+for args in "DATA.csv" "-l -j $dir/rows.csv"; do
+    "$dir/place_ip" -D $args < "$dir/queries.txt" > "$dir/out.txt" 2>&1
+    if ! grep -q "^query_allocations: 0$" "$dir/out.txt"; then
+        echo "error: place_ip -D $args allocated while serving" >&2
+        exit 1
+    fi
+done
+
+echo "all checks passed"
@@ -0,0 +1,302 @@
+// File: elias_fano.c
+//
+// Description: module for an Elias-Fano compressed index of range starts
+//
+// Each sorted start is split into its low l bits, stored packed, and its
+// high bits, stored in unary: start i sets bit (start >> l) + i of the
+// upper bitvector, so the zeros divide it into one bucket per high value.
+// The position of every SAMPLERATE-th zero is sampled, so a predecessor
+// search jumps to its bucket with one sample read and a short popcount
+// scan, then compares the low bits of the few starts in that bucket.
+// A single range keeps all 32 bits low, so the high parts are computed in
+// 64 bits, where a shift by 32 is defined.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include <stdint.h>
+
+#include "elias_fano.h"
+
+
+
+#define SAMPLERATE 256
+// zeros between select samples
+
+
+#define WORDBITS 64
+// bits per bitvector word
+
+
+
+/// Defines the struct for the EliasFano ADT
+struct EliasFano_s {
+
+    size_t count;
+    unsigned int low_bits;
+    // number of starts and low bits kept per start
+
+    uint64_t * lower;
+    // packed low bits
+
+    uint64_t * upper;
+    size_t upper_bits;
+    // unary-coded high bits
+
+    size_t * samples;
+    size_t num_samples;
+    // position of every SAMPLERATE-th zero of upper
+
+    ikey_t * ends;
+    // last key of each range, to reject keys in gaps
+
+};
+
+
+
+/// Counts the set bits of a word.
+///
+/// @param word - the word
+///
+/// @return the number of set bits
+
+static unsigned int ef_popcount(uint64_t word) {
+
+#ifdef __GNUC__
+
+    return (unsigned int) __builtin_popcountll(word);
+
+#else
+
+    unsigned int count = 0;
+
+    for (; word != 0; word &= word - 1)
+        count++;
+
+    return count;
+
+#endif
+
+}
+
+
+
+/// Reads the packed low bits of a start.
+///
+/// @param index - the EliasFano instance
+/// @param i - the start's position
+///
+/// @return the low bits
+
+static ikey_t ef_low(EliasFano index, size_t i) {
+
+    if (index->low_bits == 0)
+        return 0;
+
+    size_t bit = i * index->low_bits;
+    size_t word = bit / WORDBITS;
+    size_t shift = bit % WORDBITS;
+
+    uint64_t value = index->lower[word] >> shift;
+
+    if (shift + index->low_bits > WORDBITS)  // straddles two words
+        value |= index->lower[word + 1] << (WORDBITS - shift);
+
+    return (ikey_t) (value & ((1ULL << index->low_bits) - 1));
+
+}
+
+
+
+/// Frees all storage used by the index.
+
+void ef_destroy(EliasFano index) {
+
+    free(index->lower);
+    free(index->upper);
+    free(index->samples);
+    free(index->ends);
+    free(index);
+
+}
+
+
+
+/// Builds the index from normalized ranges.
+
+EliasFano ef_build(Ranges ranges) {
+
+    EliasFano index = (EliasFano) calloc(1, sizeof(struct EliasFano_s));
+
+    if (index == NULL)  // signifies an allocation failure
+        return NULL;
+
+    struct Range_s * items = rng_items(ranges);
+
+    index->count = rng_count(ranges);
+
+    while (index->count > 0 &&
+        (1ULL << (index->low_bits + 1)) * index->count <= (1ULL << 32))
+        index->low_bits++;
+    // l = floor(log2(U / n))
+
+    size_t buckets = (size_t) ((1ULL << 32) >> index->low_bits);
+    size_t lower_words = (index->count * index->low_bits) / WORDBITS + 2;
+
+    index->upper_bits = index->count + buckets;
+    index->num_samples = buckets / SAMPLERATE + 1;
+
+    index->lower = (uint64_t *) calloc(lower_words, sizeof(uint64_t));
+    index->upper = (uint64_t *) calloc(index->upper_bits / WORDBITS + 1,
+        sizeof(uint64_t));
+    index->samples = (size_t *) malloc(index->num_samples * sizeof(size_t));
+    index->ends = (ikey_t *) malloc((index->count + 1) * sizeof(ikey_t));
+
+    if (index->lower == NULL || index->upper == NULL ||
+        index->samples == NULL || index->ends == NULL) {  // allocation failure
+
+        ef_destroy(index);
+        return NULL;
+
+    }
+
+    for (size_t i = 0; i < index->count; i++) {  // encodes each start
+
+        ikey_t start = items[i].lo;
+        size_t high = (size_t) ((unsigned long long) start >>
+            index->low_bits) + i;
+        index->ends[i] = items[i].hi;
+        index->upper[high / WORDBITS] |= 1ULL << (high % WORDBITS);
+
+        if (index->low_bits > 0) {  // packs the low bits
+
+            uint64_t low = start & ((1ULL << index->low_bits) - 1);
+            size_t bit = i * index->low_bits;
+
+            index->lower[bit / WORDBITS] |= low << (bit % WORDBITS);
+
+            if (bit % WORDBITS + index->low_bits > WORDBITS)
+                index->lower[bit / WORDBITS + 1] |=
+                    low >> (WORDBITS - bit % WORDBITS);
+
+        }
+
+    }
+
+    size_t zeros = 0;
+
+    for (size_t pos = 0; pos < index->upper_bits; pos++) {  // samples zeros
+
+        if (index->upper[pos / WORDBITS] & (1ULL << (pos % WORDBITS)))
+            continue;
+
+        if (zeros % SAMPLERATE == 0)
+            index->samples[zeros / SAMPLERATE] = pos;
+
+        zeros++;
+
+    }
+
+    return index;
+
+}
+
+
+
+/// Finds the position just past the zero ending a bucket.
+///
+/// @param index - the EliasFano instance
+/// @param bucket - the bucket (high value)
+///
+/// @return the first position of bucket + 1
+
+static size_t ef_bucket_end(EliasFano index, size_t bucket) {
+
+    size_t pos = index->samples[bucket / SAMPLERATE];
+    size_t skip = bucket % SAMPLERATE;
+    // zeros still to pass after the sampled one
+
+    size_t word = pos / WORDBITS;
+    uint64_t bits = ~index->upper[word] & (~0ULL << (pos % WORDBITS));
+
+    while (ef_popcount(bits) <= skip) {  // skips whole words of zeros
+
+        skip -= ef_popcount(bits);
+        bits = ~index->upper[++word];
+
+    }
+
+    while (skip-- > 0)  // drops zeros before the target in this word
+        bits &= bits - 1;
+
+#ifdef __GNUC__
+
+    return word * WORDBITS + (size_t) __builtin_ctzll(bits) + 1;
+
+#else
+
+    size_t bit = 0;
+
+    while (!(bits & (1ULL << bit)))
+        bit++;
+
+    return word * WORDBITS + bit + 1;
+
+#endif
+
+}
+
+
+
+/// Finds the containing range through the predecessor start.
+
+size_t ef_lookup(EliasFano index, ikey_t key) {
+
+    if (index->count == 0)  // no starts at all
+        return RNG_NONE;
+
+    size_t high = (size_t) ((unsigned long long) key >> index->low_bits);
+    ikey_t low = key & (ikey_t) ((1ULL << index->low_bits) - 1);
+
+    size_t pos = (high == 0) ? 0 : ef_bucket_end(index, high - 1);
+    size_t i = pos - high;
+    // first position of the key's bucket, and the starts before it
+
+    size_t pred = i;
+    // one past the last start known not to exceed key
+
+    while (pos < index->upper_bits &&
+        (index->upper[pos / WORDBITS] & (1ULL << (pos % WORDBITS)))) {
+
+        if (ef_low(index, i) > low)  // starts are ascending within a bucket
+            break;
+
+        pred = ++i;
+        pos++;
+
+    }
+
+    if (pred == 0 || index->ends[pred - 1] < key)
+        return RNG_NONE;
+    // key precedes every start, or is in a gap
+
+    return pred - 1;
+
+}
+
+
+
+/// Computes the bytes used by the index.
+
+size_t ef_memory(EliasFano index) {
+
+    return ((index->count * index->low_bits) / WORDBITS + 2) *
+        sizeof(uint64_t) +
+        (index->upper_bits / WORDBITS + 1) * sizeof(uint64_t) +
+        index->num_samples * sizeof(size_t) +
+        index->count * sizeof(ikey_t);
+
+}
@@ -0,0 +1,69 @@
+// File: elias_fano.h
+//
+// Description: header for an Elias-Fano compressed index of range starts
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef ELIAS_FANO_H
+#define ELIAS_FANO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+#include "ranges.h"
+
+
+
+/// EliasFano is a pointer to the EliasFano ADT.
+typedef struct EliasFano_s * EliasFano;
+
+
+
+/// Build a read-only Elias-Fano index of the range starts, taking about
+/// 2 + log2(2^32 / n) bits per range, plus each range's last key so keys
+/// in gaps are rejected without the Ranges table.
+///
+/// @param ranges - a pointer to a normalized Ranges instance
+///
+/// @return pointer to the EliasFano instance or NULL on failure
+
+EliasFano ef_build(Ranges ranges);
+
+
+
+/// Destroy the index and free all storage (the Ranges are not touched).
+///
+/// @param index - a pointer to an EliasFano instance
+
+void ef_destroy(EliasFano index);
+
+
+
+/// Find the range containing key from its predecessor range start.
+///
+/// @param index - a pointer to an EliasFano instance
+/// @param key - the key to find
+///
+/// @return the index of the containing range or RNG_NONE
+
+size_t ef_lookup(EliasFano index, ikey_t key);
+
+
+
+/// Get the bytes used by the index.
+///
+/// @param index - a pointer to an EliasFano instance
+///
+/// @return total size of the encoded starts, select samples and range
+///     ends in bytes
+
+size_t ef_memory(EliasFano index);
+
+
+
+#endif  // ELIAS_FANO_H
@@ -0,0 +1,569 @@
+// File: engines.c
+//
+// Description: module for the set of lookup engines the benchmark tools
+// build from one workload, with timed, counted search loops for each
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "engines.h"
+
+
+
+const char * BENCH_ENGINE_NAMES[] = { "trie", "bucket_trie", "art",
+    "trie_define", "lulea", "yfast", "elias_fano", "bitmap24" };
+
+static volatile size_t bench_sink;
+// receives checksums so the compiler keeps every lookup
+
+
+
+/// Shows a key the way place_ip shows addresses.
+
+void bench_show_value(Entry entry, FILE * stream) {
+
+    fprintf(stream, "%u.%u.%u.%u\n", entry->key >> 24,
+        (entry->key >> 16) & 0xff, (entry->key >> 8) & 0xff,
+        entry->key & 0xff);
+
+}
+
+
+
+/// Loads the workload into a trie.
+
+int bench_load_trie(Bench * bench, Workload work, int arena) {
+
+    bench->trie = ibt_create(bench_show_value, NULL);
+
+    if (bench->trie == NULL)  // handles trie memory allocation error
+        return 0;
+
+    if (arena != 0 && !ibt_use_arena(bench->trie, arena))  // arena error
+        return 0;
+
+    size_t rows = wkl_rows(work);
+    pfc_start(bench->counters);
+    unsigned long long start = wkl_now_ns();
+
+    for (size_t i = 0; i < rows; i++) {  // both bounds, as read_to_trie does
+
+        ibt_insert(bench->trie, wkl_lo(work, i), NULL);
+        ibt_insert(bench->trie, wkl_hi(work, i), NULL);
+
+    }
+
+    bench->build_ns[BENCH_TRIE] = wkl_now_ns() - start;
+    pfc_stop(bench->counters);
+
+    return 1;
+
+}
+
+
+
+/// Builds the other engines.
+
+int bench_build_engines(Bench * bench, Workload work) {
+
+    size_t rows = wkl_rows(work);
+    unsigned long long start = wkl_now_ns();
+
+    bench->bucket = bkt_build(bench->trie);
+    bench->build_ns[BENCH_BUCKET] = wkl_now_ns() - start;
+
+    start = wkl_now_ns();
+    bench->art = art_create(NULL, NULL);
+
+    if (bench->art == NULL)  // handles memory allocation error
+        return 0;
+
+    for (size_t i = 0; i < rows; i++)
+        if (art_insert(bench->art, wkl_lo(work, i), NULL) < 0 ||
+            art_insert(bench->art, wkl_hi(work, i), NULL) < 0)
+            return 0;
+        // handles memory allocation error
+
+    bench->build_ns[BENCH_ART] = wkl_now_ns() - start;
+
+    start = wkl_now_ns();
+
+    for (size_t i = 0; i < rows; i++)  // row numbers stored inline
+        if (rid_insert(&bench->rid, wkl_lo(work, i), (unsigned int) i) < 0 ||
+            rid_insert(&bench->rid, wkl_hi(work, i), (unsigned int) i) < 0)
+            return 0;
+        // handles memory allocation error
+
+    if (!rid_freeze(&bench->rid))  // leaves in key order for range scans
+        return 0;
+
+    bench->build_ns[BENCH_DEFINE] = wkl_now_ns() - start;
+
+    bench->ranges = rng_create(NULL);
+
+    if (bench->bucket == NULL || bench->art == NULL || bench->ranges == NULL)
+        return 0;
+    // handles memory allocation errors
+
+    for (size_t i = 0; i < rows; i++)
+        if (!rng_add(bench->ranges, wkl_lo(work, i), wkl_hi(work, i), NULL))
+            return 0;
+        // handles memory allocation error
+
+    rng_normalize(bench->ranges);
+    // the range tables share this untimed step
+
+    start = wkl_now_ns();
+    bench->lulea = lulea_build(bench->ranges);
+    bench->build_ns[BENCH_LULEA] = wkl_now_ns() - start;
+
+    start = wkl_now_ns();
+    bench->yfast = yft_build(bench->ranges);
+    bench->build_ns[BENCH_YFAST] = wkl_now_ns() - start;
+
+    start = wkl_now_ns();
+    bench->ef = ef_build(bench->ranges);
+    bench->build_ns[BENCH_EF] = wkl_now_ns() - start;
+
+    start = wkl_now_ns();
+    bench->bm24 = bm24_build(bench->ranges);
+    bench->build_ns[BENCH_BM24] = wkl_now_ns() - start;
+
+    return bench->lulea != NULL && bench->yfast != NULL && bench->ef != NULL &&
+        bench->bm24 != NULL;
+
+}
+
+
+
+/// Destroys the engines that were built.
+
+void bench_destroy(Bench * bench) {
+
+    if (bench->bm24 != NULL)
+        bm24_destroy(bench->bm24);
+
+    if (bench->ef != NULL)
+        ef_destroy(bench->ef);
+
+    if (bench->yfast != NULL)
+        yft_destroy(bench->yfast);
+
+    if (bench->lulea != NULL)
+        lulea_destroy(bench->lulea);
+
+    if (bench->ranges != NULL)
+        rng_destroy(bench->ranges);
+
+    rid_destroy(&bench->rid);
+
+    if (bench->art != NULL)
+        art_destroy(bench->art);
+
+    if (bench->bucket != NULL)
+        bkt_destroy(bench->bucket);
+
+    if (bench->trie != NULL)
+        ibt_destroy(bench->trie);
+
+}
+
+
+
+/// Runs a query stream through one engine.
+
+size_t bench_search(Bench * bench, int engine, ikey_t * keys, size_t count) {
+
+    size_t sum = 0;
+    unsigned int row;
+
+    switch (engine) {  // one loop per engine keeps dispatch out of the timing
+
+        case BENCH_TRIE:
+            for (size_t i = 0; i < count; i++)
+                sum += ibt_search(bench->trie, keys[i])->key;
+            break;
+
+        case BENCH_BUCKET:
+            for (size_t i = 0; i < count; i++)
+                sum += bkt_search(bench->bucket, keys[i])->key;
+            break;
+
+        case BENCH_ART:
+            for (size_t i = 0; i < count; i++)
+                sum += art_search(bench->art, keys[i])->key;
+            break;
+
+        case BENCH_DEFINE:
+            for (size_t i = 0; i < count; i++)
+                if (rid_search(&bench->rid, keys[i], &row))
+                    sum += row;
+            break;
+
+        case BENCH_LULEA:
+            for (size_t i = 0; i < count; i++)
+                sum += lulea_lookup(bench->lulea, keys[i]);
+            break;
+
+        case BENCH_YFAST:
+            for (size_t i = 0; i < count; i++)
+                sum += yft_lookup(bench->yfast, keys[i]);
+            break;
+
+        case BENCH_EF:
+            for (size_t i = 0; i < count; i++)
+                sum += ef_lookup(bench->ef, keys[i]);
+            break;
+
+        default:
+            for (size_t i = 0; i < count; i++)
+                sum += bm24_lookup(bench->bm24, keys[i]);
+            break;
+
+    }
+
+    return sum;
+
+}
+
+
+
+/// Answers one key with one engine.
+///
+/// @param bench - the engine set (passed as pointer)
+/// @param engine - the engine index
+/// @param key - the key to find
+///
+/// @return the closest key for a closest-match engine, else the index of
+///     the containing range or RNG_NONE
+
+static size_t bench_answer(Bench * bench, int engine, ikey_t key) {
+
+    switch (engine) {
+
+        case BENCH_TRIE:
+            return ibt_search(bench->trie, key)->key;
+
+        case BENCH_BUCKET:
+            return bkt_search(bench->bucket, key)->key;
+
+        case BENCH_ART:
+            return art_search(bench->art, key)->key;
+
+        case BENCH_DEFINE:
+            return bench->rid.keys[rid_find(&bench->rid, key)];
+
+        case BENCH_LULEA:
+            return lulea_lookup(bench->lulea, key);
+
+        case BENCH_YFAST:
+            return yft_lookup(bench->yfast, key);
+
+        case BENCH_EF:
+            return ef_lookup(bench->ef, key);
+
+        default:
+            return bm24_lookup(bench->bm24, key);
+
+    }
+
+}
+
+
+
+/// Picks the i-th key a check probes: the query streams, then each row's
+/// first key and the one before it, last key and the one after it.
+///
+/// @param work - the rows
+/// @param streams - the query streams
+/// @param kinds - the number of streams
+/// @param count - the number of keys in each stream
+/// @param i - the probe number, below kinds * count + 4 * rows
+///
+/// @return the key
+
+static ikey_t bench_probe(Workload work, ikey_t * streams[], int kinds,
+    size_t count, size_t i) {
+
+    size_t edge = i - (size_t) kinds * count;
+
+    if (i < (size_t) kinds * count)  // the query streams
+        return streams[i / count][i % count];
+
+    if (edge % 4 < 2)  // each row's first key and the one before
+        return wkl_lo(work, edge / 4) - (ikey_t) (edge % 4 == 0);
+
+    return wkl_hi(work, edge / 4) + (ikey_t) (edge % 4 == 3);
+    // each row's last key and the one after
+
+}
+
+
+
+/// Compares every engine's answers with the trie's.
+
+size_t bench_check(Bench * bench, Workload work, ikey_t * streams[],
+    int kinds, size_t count, size_t mismatches[]) {
+
+    size_t rows = wkl_rows(work);
+    struct Range_s * items = rng_items(bench->ranges);
+    unsigned long long covered = 0;
+    unsigned long long kept = 0;
+
+    for (size_t i = 0; i < rows; i++) {  // keys covered by the rows
+
+        ikey_t lo = wkl_lo(work, i);
+        ikey_t hi = wkl_hi(work, i);
+
+        covered += (lo <= hi) ? hi - lo + 1ULL : lo - hi + 1ULL;
+
+    }
+
+    for (size_t r = 0; r < rng_count(bench->ranges); r++)
+        kept += items[r].hi - items[r].lo + 1ULL;
+
+    int disjoint = (rng_count(bench->ranges) == rows && kept == covered);
+    // normalizing clipped nothing, so every range is a row
+
+    for (int e = 0; e < BENCH_ENGINES; e++)
+        mismatches[e] = 0;
+
+    size_t total = (size_t) kinds * count + 4 * rows;
+
+    for (size_t i = 0; i < total; i++) {
+
+        ikey_t key = bench_probe(work, streams, kinds, count, i);
+        size_t closest = bench_answer(bench, BENCH_TRIE, key);
+        size_t range = rng_find(bench->ranges, key);
+
+        for (int e = BENCH_TRIE + 1; e < BENCH_ENGINES; e++)
+            if (bench_answer(bench, e, key) !=
+                ((e <= BENCH_DEFINE) ? closest : range))
+                mismatches[e]++;
+        // closest-match engines must find the trie's key, containment
+        // engines the range rng_find finds
+
+        if (disjoint && range != RNG_NONE && (closest < items[range].lo ||
+            closest > items[range].hi))
+            mismatches[BENCH_TRIE]++;
+        // the trie's closest key lies in the range holding the query key
+
+    }
+
+    return total;
+
+}
+
+
+
+/// Orders two keys for qsort.
+///
+/// @param a - the first key
+/// @param b - the second key
+///
+/// @return negative, zero or positive as a is below, equal to or above b
+
+static int bench_key_compare(const void * a, const void * b) {
+
+    ikey_t x = *(const ikey_t *) a;
+    ikey_t y = *(const ikey_t *) b;
+
+    return (x > y) - (x < y);
+
+}
+
+
+
+/// Checks the trie's order queries against a sorted key array: select and
+/// rank at every position, then rank, select of rank, predecessor and
+/// successor at every probe key.
+///
+/// @param trie - the trie
+/// @param sorted - the trie's keys in ascending order
+/// @param size - the number of keys
+/// @param work - the rows
+/// @param streams - the query streams
+/// @param kinds - the number of streams
+/// @param count - the number of keys in each stream
+///
+/// @return the number of wrong answers
+
+static size_t bench_check_sorted(Trie trie, ikey_t * sorted, size_t size,
+    Workload work, ikey_t * streams[], int kinds, size_t count) {
+
+    size_t wrong = (ibt_size(trie) != size) + (ibt_select(trie, size) != NULL);
+
+    for (size_t i = 0; i < size; i++) {  // every position
+
+        Entry entry = ibt_select(trie, i);
+
+        wrong += (entry == NULL || entry->key != sorted[i]);
+        wrong += (ibt_rank(trie, sorted[i]) != i);
+
+    }
+
+    size_t total = (size_t) kinds * count + 4 * wkl_rows(work);
+
+    for (size_t i = 0; i < total; i++) {  // every probe key
+
+        ikey_t key = bench_probe(work, streams, kinds, count, i);
+        size_t lo = 0;
+        size_t hi = size;
+
+        while (lo < hi) {  // counts the keys below key
+
+            size_t mid = lo + (hi - lo) / 2;
+
+            if (sorted[mid] < key)
+                lo = mid + 1;
+            else
+                hi = mid;
+
+        }
+
+        size_t rank = ibt_rank(trie, key);
+        Entry at = ibt_select(trie, rank);
+        Entry succ = ibt_successor(trie, key);
+        Entry pred = ibt_predecessor(trie, key);
+
+        wrong += (rank != lo);
+        wrong += (lo < size) ? (at == NULL || at->key != sorted[lo]) :
+            (at != NULL);
+        // select of rank is the successor
+
+        wrong += (lo < size) ? (succ == NULL || succ->key != sorted[lo]) :
+            (succ != NULL);
+
+        size_t below = (lo < size && sorted[lo] == key) ? lo + 1 : lo;
+        // keys not above key
+
+        wrong += (below > 0) ?
+            (pred == NULL || pred->key != sorted[below - 1]) : (pred != NULL);
+
+    }
+
+    return wrong;
+
+}
+
+
+
+/// Checks the trie's order queries, then again after more inserts.
+
+size_t bench_check_order(Bench * bench, Workload work, ikey_t * streams[],
+    int kinds, size_t count, size_t * mismatches) {
+
+    size_t rows = wkl_rows(work);
+    size_t extra = (count < ORDEREXTRA) ? count : ORDEREXTRA;
+    ikey_t * sorted = (ikey_t *) malloc((2 * rows + extra + 1) *
+        sizeof(ikey_t));
+
+    if (sorted == NULL)  // handles memory allocation error
+        return 0;
+
+    for (size_t i = 0; i < rows; i++) {  // the keys the trie was built from
+
+        sorted[2 * i] = wkl_lo(work, i);
+        sorted[2 * i + 1] = wkl_hi(work, i);
+
+    }
+
+    size_t size = 0;
+    size_t checked = 0;
+
+    for (int pass = 0; pass < 2; pass++) {
+
+        size_t added = (pass == 0) ? 2 * rows : size + extra;
+
+        if (pass == 1)
+            for (size_t i = 0; i < extra; i++) {  // unpushes and drops jumps
+
+                ikey_t key = streams[0][i] ^ ORDERSALT;
+
+                ibt_insert(bench->trie, key, NULL);
+                sorted[size + i] = key;
+
+            }
+
+        qsort(sorted, added, sizeof(ikey_t), bench_key_compare);
+        size = 0;
+
+        for (size_t i = 0; i < added; i++)  // drops duplicate keys
+            if (size == 0 || sorted[size - 1] != sorted[i])
+                sorted[size++] = sorted[i];
+
+        *mismatches += bench_check_sorted(bench->trie, sorted, size, work,
+            streams, kinds, count);
+        checked += size + (size_t) kinds * count + 4 * rows;
+
+    }
+
+    free(sorted);
+
+    return checked;
+
+}
+
+
+
+/// Times a query stream through one engine.
+
+double bench_time_search(Bench * bench, int engine, ikey_t * keys,
+    size_t count) {
+
+    if (count == 0)  // nothing to time
+        return 0;
+
+    bench_sink += bench_search(bench, engine, keys,
+        (count < WARMUP) ? count : WARMUP);
+    // brings the hot part of the structure into cache
+
+    pfc_start(bench->counters);
+    unsigned long long start = wkl_now_ns();
+    bench_sink += bench_search(bench, engine, keys, count);
+    unsigned long long ns = wkl_now_ns() - start;
+    pfc_stop(bench->counters);
+
+    return (double) ns / (double) count;
+
+}
+
+
+
+/// Times and counts showing search answers.
+
+double bench_time_show(Bench * bench, Entry * answers, size_t count,
+    FILE * stream) {
+
+    if (count == 0)  // nothing to time
+        return 0;
+
+    pfc_start(bench->counters);
+    unsigned long long start = wkl_now_ns();
+
+    for (size_t i = 0; i < count; i++)
+        ibt_show_value(bench->trie, answers[i], stream);
+
+    fflush(stream);
+    unsigned long long ns = wkl_now_ns() - start;
+    pfc_stop(bench->counters);
+
+    return (double) ns / (double) count;
+
+}
+
+
+
+/// Profiles a query stream and repacks the trie nodes.
+
+void bench_relayout(Bench * bench, ikey_t * keys, size_t count) {
+
+    ibt_profile(bench->trie, 1);
+    bench_sink += bench_search(bench, BENCH_TRIE, keys, count);
+    ibt_relayout(bench->trie);
+    ibt_profile(bench->trie, 0);
+
+}
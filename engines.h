@@ -0,0 +1,240 @@
+// File: engines.h
+//
+// Description: header for the engine set built by the benchmark tools
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef ENGINES_H
+#define ENGINES_H
+
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE
+#endif
+// exposes getopt and the clock to the benchmark tools
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "trie.h"
+#include "trie_define.h"
+#include "bucket_trie.h"
+#include "art.h"
+#include "ranges.h"
+#include "lulea.h"
+#include "yfast.h"
+#include "elias_fano.h"
+#include "bitmap24.h"
+#include "workload.h"
+#include "perf_counters.h"
+
+#define BENCH_TRIE 0
+#define BENCH_BUCKET 1
+#define BENCH_ART 2
+#define BENCH_DEFINE 3
+#define BENCH_LULEA 4
+#define BENCH_YFAST 5
+#define BENCH_EF 6
+#define BENCH_BM24 7
+// engine indices
+
+#define BENCH_ENGINES 8
+// number of engines measured
+
+#define WARMUP 100000
+// most queries run untimed before each measurement
+
+#define ORDEREXTRA 10000
+// most keys the order check inserts into the built trie
+
+#define ORDERSALT 0x5bd1e995u
+// spreads the order check's extra keys away from the query keys
+
+
+
+IBT_DEFINE(rid, ikey_t, unsigned int)
+// the specialized trie, holding row numbers inline
+
+
+
+/// Bench holds every engine built from one workload.
+struct Bench_s {
+
+    Trie trie;
+    BucketTrie bucket;
+    Art art;
+    rid_t rid;
+    // closest-match engines, loaded with both bounds of every row
+
+    Ranges ranges;
+    Lulea lulea;
+    YFast yfast;
+    EliasFano ef;
+    Bitmap24 bm24;
+    // containment engines, built from the normalized rows
+
+    unsigned long long build_ns[BENCH_ENGINES];
+    // time taken to build each engine
+
+    Counters counters;
+    // hardware counters read around each measured phase
+
+};
+
+
+
+/// Defines Bench as the (stack allocatable) engine set struct.
+typedef struct Bench_s Bench;
+
+
+
+extern const char * BENCH_ENGINE_NAMES[];  /// < engine names, by index
+
+
+
+/// Shows an entry's key in "dot" notation.
+///
+/// @param entry - the entry to show
+/// @param stream - the output stream
+
+void bench_show_value(Entry entry, FILE * stream);
+
+
+
+/// Loads both bounds of every workload row into a trie, timing and
+/// counting the inserts.
+///
+/// @param bench - the engine set (passed as pointer)
+/// @param work - the rows to load
+/// @param arena - arena flags for the trie nodes, or 0 for malloc
+///
+/// @return 1 on success, 0 on failure
+
+int bench_load_trie(Bench * bench, Workload work, int arena);
+
+
+
+/// Builds every other engine from the workload and the loaded trie,
+/// timing each build.
+///
+/// @param bench - the engine set (passed as pointer)
+/// @param work - the rows to load
+///
+/// @return 1 on success, 0 on failure
+
+int bench_build_engines(Bench * bench, Workload work);
+
+
+
+/// Destroys every engine that was built.
+///
+/// @param bench - the engine set (passed as pointer)
+
+void bench_destroy(Bench * bench);
+
+
+
+/// Runs a query stream through an engine.
+///
+/// @param bench - the engine set (passed as pointer)
+/// @param engine - the engine index
+/// @param keys - the query keys
+/// @param count - the number of keys
+///
+/// @return a checksum of the answers, so no lookup can be skipped
+
+size_t bench_search(Bench * bench, int engine, ikey_t * keys, size_t count);
+
+
+
+/// Checks every engine against the trie on the query streams and on
+/// the first and last key of every row and the keys just outside them.
+/// Closest-match engines must return the trie's key. Containment engines
+/// must return the range rng_find returns; when no rows overlap, the
+/// trie's key must also lie in that range, which ties those answers to
+/// ibt_search.
+///
+/// @param bench - the engine set, with every engine built (passed as
+///     pointer)
+/// @param work - the rows the engines were built from
+/// @param streams - the query streams
+/// @param kinds - the number of streams
+/// @param count - the number of keys in each stream
+/// @param mismatches - receives the disagreements per engine; the trie's
+///     entry counts trie keys outside the containing range
+///
+/// @return the number of keys checked
+
+size_t bench_check(Bench * bench, Workload work, ikey_t * streams[],
+    int kinds, size_t count, size_t mismatches[]);
+
+
+
+/// Checks the trie's ibt_select, ibt_rank, ibt_predecessor and
+/// ibt_successor against a sorted array of its keys: select and rank at
+/// every position, and rank, select of rank, predecessor and successor at
+/// the probe keys bench_check uses. The check then inserts up to
+/// ORDEREXTRA more keys, which undoes leaf pushing and drops the jump
+/// table, and checks again, so the subtree counts are tested through
+/// whatever layout the trie had and through later inserts.
+///
+/// @param bench - the engine set (passed as pointer); its trie grows
+/// @param work - the rows the trie was built from
+/// @param streams - the query streams
+/// @param kinds - the number of streams
+/// @param count - the number of keys in each stream
+/// @param mismatches - incremented once per wrong answer
+///
+/// @return the number of positions and keys checked (0 on memory error)
+
+size_t bench_check_order(Bench * bench, Workload work, ikey_t * streams[],
+    int kinds, size_t count, size_t * mismatches);
+
+
+
+/// Times and counts a query stream through an engine after a short
+/// warm-up.
+///
+/// @param bench - the engine set (passed as pointer)
+/// @param engine - the engine index
+/// @param keys - the query keys
+/// @param count - the number of keys
+///
+/// @return nanoseconds per lookup
+
+double bench_time_search(Bench * bench, int engine, ikey_t * keys,
+    size_t count);
+
+
+
+/// Times and counts showing a set of search answers.
+///
+/// @param bench - the engine set (passed as pointer)
+/// @param answers - the entries to show
+/// @param count - the number of entries
+/// @param stream - the output stream
+///
+/// @return nanoseconds per entry shown
+
+double bench_time_show(Bench * bench, Entry * answers, size_t count,
+    FILE * stream);
+
+
+
+/// Counts visits to the trie nodes on a query stream and repacks the
+/// nodes hottest path first.
+///
+/// @param bench - the engine set (passed as pointer)
+/// @param keys - the query keys
+/// @param count - the number of keys
+
+void bench_relayout(Bench * bench, ikey_t * keys, size_t count);
+
+
+
+#endif  // ENGINES_H
@@ -0,0 +1,340 @@
+// File: gen_geoip.c
+//
+// Description: generates synthetic IP location CSV files in the format
+// place_ip reads, with configurable size, range lengths, location
+// cardinality, overlap and row order
+//
+// @author: Max Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "gen_geoip.h"
+
+
+#define ROWS 100000
+// default number of rows
+
+
+#define USAGE "usage: gen_geoip [-n rows] [-f pct_24] [-b pct_huge] " \
+    "[-c locations] [-v pct_overlap] [-r a|d|r] [-s seed] [filename]\n"
+// command usage message
+
+
+
+static const char * COUNTRIES[][2] = {
+    { "US", "United States" }, { "CN", "China" }, { "JP", "Japan" },
+    { "DE", "Germany" }, { "GB", "United Kingdom" }, { "KR", "Korea" },
+    { "BR", "Brazil" }, { "FR", "France" }, { "CA", "Canada" },
+    { "IT", "Italy" }, { "AU", "Australia" }, { "NL", "Netherlands" },
+    { "RU", "Russian Federation" }, { "IN", "India" }, { "ES", "Spain" },
+    { "SE", "Sweden" }, { "PL", "Poland" }, { "MX", "Mexico" },
+    { "IR", "Iran (Islamic Republic of)" }, { "SA", "Saudi Arabia" },
+    { "TR", "Turkey" }, { "ZA", "South Africa" }, { "AR", "Argentina" },
+    { "EG", "Egypt" }
+};
+// countries, roughly by address share; location i is in country
+// i % NCOUNTRIES, so low (popular) locations spread over the list
+
+#define NCOUNTRIES (sizeof(COUNTRIES) / sizeof(COUNTRIES[0]))
+
+
+
+/// Draws a range length from the mix of /24, huge and small ranges.
+
+unsigned long long draw_length(Params * params, unsigned long long * state,
+    unsigned long long * align) {
+
+    unsigned int pick = (unsigned int) (wkl_random(state) % 100);
+
+    if (pick < params->pct24) {  // one aligned /24
+
+        *align = 256;
+        return 256;
+
+    }
+
+    if (pick < params->pct24 + params->pcthuge) {  // an aligned /8 to /16
+
+        unsigned int bits = HUGEMIN +
+            (unsigned int) (wkl_random(state) % (HUGEMAX - HUGEMIN + 1));
+
+        *align = 1ULL << (BITSPERWORD - bits);
+        return *align;
+
+    }
+
+    *align = 1;
+
+    return 1 + wkl_random(state) %
+        (1ULL << (1 + wkl_random(state) % SMALLBITS));
+    // log-uniform length up to 2^SMALLBITS
+
+}
+
+
+
+/// Draws a location for a row.
+
+unsigned int draw_location(Params * params, unsigned long long * state,
+    unsigned int prev) {
+
+    if (prev != NOLOCATION && wkl_random(state) % 100 < RUNPCT)  // runs
+        return prev;
+
+    double u = (double) (wkl_random(state) >> 11) / (double) (1ULL << 53);
+
+    return (unsigned int) (u * u * params->locations);
+    // squaring skews the draw toward low (popular) locations
+
+}
+
+
+
+/// Generates the rows in ascending key order.
+
+int generate_rows(Params * params, Rows * rows) {
+
+    size_t n = params->rows;
+
+    rows->lo = (ikey_t *) malloc(n * sizeof(ikey_t));
+    rows->hi = (ikey_t *) malloc(n * sizeof(ikey_t));
+    rows->loc = (unsigned int *) malloc(n * sizeof(unsigned int));
+    rows->count = n;
+
+    if (rows->lo == NULL || rows->hi == NULL || rows->loc == NULL)
+        return 0;
+    // handles memory allocation error
+
+    unsigned long long space = 1ULL << BITSPERWORD;
+    double share = (double) space / (double) n;
+    unsigned long long cursor = 0;
+    unsigned long long state = params->seed;
+    unsigned int loc = NOLOCATION;
+
+    for (size_t i = 0; i < n; i++) {
+
+        unsigned long long limit =
+            (unsigned long long) ((double) (i + 1 + LOOKAHEAD) * share);
+        unsigned long long reserve = space - (n - i - 1);
+        // this row ends by limit, leaving one key for every later row
+
+        if (limit > reserve)
+            limit = reserve;
+
+        unsigned long long align;
+        unsigned long long len = draw_length(params, &state, &align);
+        unsigned long long lo;
+
+        if (i > 0 && wkl_random(&state) % 100 < params->pctoverlap) {
+
+            lo = rows->lo[i - 1] + wkl_random(&state) %
+                ((unsigned long long) rows->hi[i - 1] - rows->lo[i - 1] + 1);
+
+        } else {
+
+            lo = (cursor + align - 1) / align * align;
+
+            while (align > 1 && lo + len > limit) {  // halves to fit
+
+                len >>= 1;
+                align = len;
+                lo = (cursor + align - 1) / align * align;
+
+            }
+
+        }
+        // overlapping rows start inside the previous row; others start at
+        // the cursor, rounded up to their alignment
+
+        if (lo + len > limit)  // shortens the range to keep pace
+            len = limit - lo;
+
+        if (align >= (1ULL << (BITSPERWORD - HUGEMAX)) &&
+            wkl_random(&state) % 2 == 0)  // half of huge blocks unassigned
+            rows->loc[i] = NOLOCATION;
+        else
+            rows->loc[i] = loc = draw_location(params, &state, loc);
+
+        rows->lo[i] = (ikey_t) lo;
+        rows->hi[i] = (ikey_t) (lo + len - 1);
+
+        if (lo + len > cursor)
+            cursor = lo + len;
+
+        unsigned long long pace = (unsigned long long) ((double) (i + 1) *
+            share);
+
+        if (pace > reserve)
+            pace = reserve;
+
+        if (cursor < pace)  // leaves an unassigned gap up to the pace
+            cursor += wkl_random(&state) % (pace - cursor + 1);
+
+    }
+
+    return 1;
+
+}
+
+
+
+/// Puts the rows in the requested order.
+
+void order_rows(Params * params, Rows * rows) {
+
+    size_t n = rows->count;
+    unsigned long long state = params->seed ^ 0x5bd1e995ULL;
+
+    for (size_t i = 0; i + 1 < n; i++) {  // swap pass over the rows
+
+        size_t j;
+
+        if (params->order == 'd' && i < n - 1 - i)  // reverses
+            j = n - 1 - i;
+        else if (params->order == 'r')  // Fisher-Yates shuffle
+            j = i + (size_t) (wkl_random(&state) % (n - i));
+        else
+            break;
+
+        ikey_t lo = rows->lo[i];
+        ikey_t hi = rows->hi[i];
+        unsigned int loc = rows->loc[i];
+
+        rows->lo[i] = rows->lo[j];
+        rows->hi[i] = rows->hi[j];
+        rows->loc[i] = rows->loc[j];
+        rows->lo[j] = lo;
+        rows->hi[j] = hi;
+        rows->loc[j] = loc;
+
+    }
+
+}
+
+
+
+/// Writes one CSV row.
+
+void write_row(Rows * rows, size_t i, FILE * stream) {
+
+    unsigned int loc = rows->loc[i];
+
+    if (loc == NOLOCATION) {  // unassigned block
+
+        fprintf(stream, "\"%u\",\"%u\",\"-\",\"-\",\"-\",\"-\"\n",
+            rows->lo[i], rows->hi[i]);
+
+        return;
+
+    }
+
+    const char ** country = COUNTRIES[loc % NCOUNTRIES];
+
+    fprintf(stream, "\"%u\",\"%u\",\"%s\",\"%s\",\"Region %u\","
+        "\"City %u\"\n", rows->lo[i], rows->hi[i], country[0], country[1],
+        (unsigned int) (loc / NCOUNTRIES % 64), loc);
+    // a location's city number is unique; regions group its neighbors
+
+}
+
+
+
+/// Program entry point.
+/// Generates rows with the requested shape and writes them as CSV.
+///
+/// @param argc - number of command line arguments
+/// @param argv - command line arguments
+///
+/// @return EXIT_SUCCESS or EXIT_FAILURE if error occurs
+
+int main(int argc, char * argv[]) {
+
+    Params params = { ROWS, 60, 1, 10000, 0, 'a', 1 };
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:f:b:c:v:r:s:")) != -1) {
+
+        switch (opt) {
+
+            case 'n':  // rows to generate
+                params.rows = (size_t) strtoull(optarg, NULL, 10);
+                break;
+
+            case 'f':  // percent of /24 rows
+                params.pct24 = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'b':  // percent of huge block rows
+                params.pcthuge = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'c':  // distinct locations
+                params.locations = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'v':  // percent of rows overlapping the previous one
+                params.pctoverlap = (unsigned int) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'r':  // row order
+                params.order = optarg[0];
+                break;
+
+            case 's':  // random seed
+                params.seed = strtoull(optarg, NULL, 10);
+                break;
+
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+
+        }
+
+    }
+
+    if (argc - optind > 1 || params.rows == 0 ||
+        params.rows > (1ULL << BITSPERWORD) || params.locations == 0 ||
+        params.pct24 + params.pcthuge > 100 || params.pctoverlap > 100 ||
+        strchr("adr", params.order) == NULL || params.order == '\0') {
+
+        fprintf(stderr, USAGE);
+        return EXIT_FAILURE;
+
+    }
+    // handles incorrect command arguments error
+
+    FILE * out = stdout;
+
+    if (optind < argc && (out = fopen(argv[optind], "w")) == NULL) {
+
+        perror(argv[optind]);
+        return EXIT_FAILURE;
+
+    }
+
+    Rows rows;
+
+    if (!generate_rows(&params, &rows)) {  // handles memory allocation error
+
+        fprintf(stderr, "error: failed to allocate memory for rows\n");
+        return EXIT_FAILURE;
+
+    }
+
+    order_rows(&params, &rows);
+
+    for (size_t i = 0; i < rows.count; i++)
+        write_row(&rows, i, out);
+
+    if (out != stdout)
+        fclose(out);
+
+    free(rows.lo);
+    free(rows.hi);
+    free(rows.loc);
+
+    return EXIT_SUCCESS;
+
+}
@@ -0,0 +1,149 @@
+// File: gen_geoip.h
+//
+// Description: function declarations and constants for the gen_geoip module
+//
+// @author: Max Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef GEN_GEOIP
+#define GEN_GEOIP
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "workload.h"
+
+#define LOOKAHEAD 1024
+// row shares a range may borrow ahead of its own pace
+
+#define RUNPCT 50
+// percent of rows keeping the previous row's location
+
+#define HUGEMIN 8
+#define HUGEMAX 16
+// prefix lengths of huge blocks
+
+#define SMALLBITS 10
+// small ranges hold up to 2^SMALLBITS keys
+
+#define NOLOCATION ((unsigned int) -1)
+// location of unassigned blocks, written as "-" fields
+
+
+
+/// Rows holds the generated ranges and their locations.
+struct Rows_s {
+
+    ikey_t * lo;
+    ikey_t * hi;
+    unsigned int * loc;
+    // per row bounds and location index
+
+    size_t count;
+
+};
+
+
+
+/// Defines Rows as the (stack allocatable) row set struct.
+typedef struct Rows_s Rows;
+
+
+
+/// Params holds the generator settings.
+struct Params_s {
+
+    size_t rows;
+    // number of rows to generate
+
+    unsigned int pct24;
+    unsigned int pcthuge;
+    // percent of rows that are aligned /24 and huge (/8 to /16) blocks;
+    // the rest are small ranges of log-uniform length
+
+    unsigned int locations;
+    // number of distinct locations
+
+    unsigned int pctoverlap;
+    // percent of rows starting inside the previous row
+
+    char order;
+    // 'a'scending, 'd'escending or 'r'andom row order
+
+    unsigned long long seed;
+
+};
+
+
+
+/// Defines Params as the (stack allocatable) settings struct.
+typedef struct Params_s Params;
+
+
+
+/// Draws a range length and its alignment from the length distribution.
+///
+/// @param params - the generator settings (passed as pointer)
+/// @param state - the generator state (passed as pointer)
+/// @param align - the alignment of the range start (passed as pointer)
+///
+/// @return the range length
+
+unsigned long long draw_length(Params * params, unsigned long long * state,
+    unsigned long long * align);
+
+
+
+/// Draws a location, repeating the previous one for runs of rows and
+/// otherwise favoring low location indices.
+///
+/// @param params - the generator settings (passed as pointer)
+/// @param state - the generator state (passed as pointer)
+/// @param prev - the previous row's location
+///
+/// @return the location index
+
+unsigned int draw_location(Params * params, unsigned long long * state,
+    unsigned int prev);
+
+
+
+/// Generates rows in ascending key order, pacing them so they always fit
+/// in the key space; lengths that would outrun the pace are shortened.
+///
+/// @param params - the generator settings (passed as pointer)
+/// @param rows - the row set to fill (passed as pointer)
+///
+/// @return 1 on success, 0 on allocation failure
+
+int generate_rows(Params * params, Rows * rows);
+
+
+
+/// Shuffles or reverses the rows into the requested order.
+///
+/// @param params - the generator settings (passed as pointer)
+/// @param rows - the row set (passed as pointer)
+
+void order_rows(Params * params, Rows * rows);
+
+
+
+/// Writes one row in the place_ip CSV format.
+///
+/// @param rows - the row set (passed as pointer)
+/// @param i - the row index
+/// @param stream - the output stream
+
+void write_row(Rows * rows, size_t i, FILE * stream);
+
+
+
+#endif  // GEN_GEOIP
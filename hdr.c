@@ -0,0 +1,181 @@
+// File: hdr.c
+//
+// Description: module for a log-linear (HDR-style) latency histogram
+//
+// Values below 2^HDR_SUBBITS get a bucket each. Above that, the values
+// sharing a leading bit position form one octave, split into 2^HDR_SUBBITS
+// buckets by the bits that follow the leading one, so bucket width grows
+// with the value and relative precision stays fixed. Recording is a
+// leading-zero count, a shift and an increment.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "hdr.h"
+
+
+
+#define HDR_SUBBITS_VALUE 7
+// 128 buckets per octave: under 1% error
+
+#define SUB (1ULL << HDR_SUBBITS_VALUE)
+// buckets per octave
+
+#define BUCKETS ((64 - HDR_SUBBITS_VALUE + 1) * SUB)
+// bucket count covering every 64-bit value
+
+
+
+/// Defines the struct for the Hdr ADT
+struct Hdr_s {
+
+    unsigned long long counts[BUCKETS];
+    // values recorded per bucket
+
+    unsigned long long total;
+    unsigned long long max;
+    double sum;
+
+};
+
+
+
+const unsigned int HDR_SUBBITS = HDR_SUBBITS_VALUE;
+
+
+
+/// Finds the bucket of a value.
+///
+/// @param value - the value
+///
+/// @return the bucket index
+
+static size_t hdr_index(unsigned long long value) {
+
+    if (value < SUB)  // one bucket per value
+        return (size_t) value;
+
+    unsigned int msb = 63 - (unsigned int) __builtin_clzll(value);
+    unsigned int shift = msb - HDR_SUBBITS_VALUE;
+
+    return (size_t) ((shift + 1) * SUB + ((value >> shift) - SUB));
+
+}
+
+
+
+/// Finds the highest value that falls in a bucket.
+///
+/// @param index - the bucket index
+///
+/// @return the bucket's highest value
+
+static unsigned long long hdr_highest(size_t index) {
+
+    if (index < SUB)  // one bucket per value
+        return index;
+
+    unsigned int shift = (unsigned int) (index / SUB) - 1;
+    unsigned long long lead = index % SUB + SUB;
+
+    return ((lead + 1) << shift) - 1;
+
+}
+
+
+
+/// Creates an empty histogram.
+
+Hdr hdr_create(void) {
+
+    return (Hdr) calloc(1, sizeof(struct Hdr_s));
+
+}
+
+
+
+/// Frees the histogram.
+
+void hdr_destroy(Hdr hist) {
+
+    free(hist);
+
+}
+
+
+
+/// Records one value.
+
+void hdr_record(Hdr hist, unsigned long long value) {
+
+    hist->counts[hdr_index(value)]++;
+    hist->total++;
+    hist->sum += (double) value;
+
+    if (value > hist->max)
+        hist->max = value;
+
+}
+
+
+
+/// Fetches the recorded count.
+
+unsigned long long hdr_count(Hdr hist) {
+
+    return hist->total;
+
+}
+
+
+
+/// Fetches the largest recorded value.
+
+unsigned long long hdr_max(Hdr hist) {
+
+    return hist->max;
+
+}
+
+
+
+/// Computes the mean recorded value.
+
+double hdr_mean(Hdr hist) {
+
+    return (hist->total == 0) ? 0 : hist->sum / (double) hist->total;
+
+}
+
+
+
+/// Walks the buckets up to the rank of a percentile.
+
+unsigned long long hdr_percentile(Hdr hist, double percent) {
+
+    if (hist->total == 0)  // nothing recorded
+        return 0;
+
+    unsigned long long rank = (unsigned long long) (percent / 100.0 *
+        (double) hist->total + 0.5);
+
+    if (rank == 0)
+        rank = 1;
+
+    unsigned long long seen = 0;
+
+    for (size_t i = 0; i < BUCKETS; i++) {  // cumulative count reaches rank
+
+        seen += hist->counts[i];
+
+        if (seen >= rank)
+            return (hdr_highest(i) < hist->max) ? hdr_highest(i) : hist->max;
+
+    }
+
+    return hist->max;
+
+}
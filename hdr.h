@@ -0,0 +1,97 @@
+// File: hdr.h
+//
+// Description: header for a log-linear (HDR-style) latency histogram ADT
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef HDR_H
+#define HDR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+
+/// Hdr is a pointer to the Hdr ADT.
+typedef struct Hdr_s * Hdr;
+
+
+
+extern const unsigned int HDR_SUBBITS;  /// < log2 of sub-buckets per octave
+
+
+
+/// Create an empty histogram covering every 64-bit value. Each power of
+/// two is split into 2^HDR_SUBBITS equal buckets, so a recorded value is
+/// kept to within 1 part in 2^HDR_SUBBITS.
+///
+/// @return pointer to the Hdr instance or NULL on failure
+
+Hdr hdr_create(void);
+
+
+
+/// Destroy the histogram.
+///
+/// @param hist - a pointer to an Hdr instance
+
+void hdr_destroy(Hdr hist);
+
+
+
+/// Record one value. Does not allocate.
+///
+/// @param hist - a pointer to an Hdr instance
+/// @param value - the value to record
+
+void hdr_record(Hdr hist, unsigned long long value);
+
+
+
+/// Get the number of values recorded.
+///
+/// @param hist - a pointer to an Hdr instance
+///
+/// @return the count of recorded values
+
+unsigned long long hdr_count(Hdr hist);
+
+
+
+/// Get the largest value recorded (exact).
+///
+/// @param hist - a pointer to an Hdr instance
+///
+/// @return the maximum, or 0 if empty
+
+unsigned long long hdr_max(Hdr hist);
+
+
+
+/// Get the mean of the recorded values (exact).
+///
+/// @param hist - a pointer to an Hdr instance
+///
+/// @return the mean, or 0 if empty
+
+double hdr_mean(Hdr hist);
+
+
+
+/// Get the value below or at which a percentage of the recorded values
+/// lie, as the highest value of the bucket holding that rank.
+///
+/// @param hist - a pointer to an Hdr instance
+/// @param percent - the percentile, from 0 to 100
+///
+/// @return the percentile value, or 0 if empty
+
+unsigned long long hdr_percentile(Hdr hist, double percent);
+
+
+
+#endif  // HDR_H
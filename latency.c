@@ -0,0 +1,392 @@
+// File: latency.c
+//
+// Description: measures the latency distribution of trie searches, alone
+// and while another thread keeps reloading the trie, and writes p50, p99,
+// p99.9 and max as JSON
+//
+// @author: Max Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "latency.h"
+
+
+#define ROWS 1000000
+// synthetic rows when no file is given
+
+
+#define QUERIES 1000000
+// queries timed in each scenario
+
+
+#define USAGE "usage: latency [-n rows] [-q queries] [-B batch] " \
+    "[-k u|z|s] [-z zipf_s] [-s seed] [-o json_file] [-l] [-j] " \
+    "[filename]\n"
+// command usage message
+
+
+
+volatile size_t latency_sink;
+// receives checksums so the compiler keeps every lookup
+
+
+
+/// Reads the timer: the time-stamp counter where there is one, fenced so
+/// the lookups being timed cannot move across it, else the clock.
+///
+/// @return the current tick
+
+static inline unsigned long long lat_ticks(void) {
+
+#if defined(__x86_64__) || defined(__i386__)
+
+    _mm_lfence();
+    unsigned long long ticks = __rdtsc();
+    _mm_lfence();
+
+    return ticks;
+
+#else
+
+    return wkl_now_ns();
+
+#endif
+
+}
+
+
+
+/// Builds a trie from the workload rows.
+
+Trie load_trie(Workload work, char leaf_push, char jump) {
+
+    Trie trie = ibt_create(NULL, NULL);
+
+    if (trie == NULL)  // handles trie memory allocation error
+        return NULL;
+
+    for (size_t i = 0; i < wkl_rows(work); i++) {  // as read_to_trie does
+
+        ibt_insert(trie, wkl_lo(work, i), NULL);
+        ibt_insert(trie, wkl_hi(work, i), NULL);
+
+    }
+
+    if (leaf_push)
+        ibt_leaf_push(trie);
+
+    if (jump)  // searches still work without it
+        ibt_jump_build(trie);
+
+    return trie;
+
+}
+
+
+
+/// Times the tick counter against the monotonic clock.
+
+double calibrate_ticks(void) {
+
+    unsigned long long ns0 = wkl_now_ns();
+    unsigned long long t0 = lat_ticks();
+    unsigned long long ns1;
+
+    do {  // spins so the clock and counter cover the same span
+
+        ns1 = wkl_now_ns();
+
+    } while (ns1 - ns0 < CALIBRATE_NS);
+
+    unsigned long long t1 = lat_ticks();
+
+    return (double) (t1 - t0) / (double) (ns1 - ns0);
+
+}
+
+
+
+/// Times batches of searches against the current trie.
+
+void run_queries(Reload * reload, ikey_t * keys, size_t count, size_t batch,
+    Hdr hist) {
+
+    size_t sum = 0;
+
+    for (size_t i = 0; i < count; i += batch) {
+
+        size_t end = (i + batch < count) ? i + batch : count;
+
+        size_t gen = __atomic_load_n(&reload->published, __ATOMIC_ACQUIRE);
+        Trie trie = __atomic_load_n(&reload->current, __ATOMIC_ACQUIRE);
+        // the trie was published at generation gen or later
+
+        unsigned long long start = lat_ticks();
+
+        for (size_t j = i; j < end; j++)
+            sum += ibt_search(trie, keys[j])->key;
+
+        unsigned long long ticks = lat_ticks() - start;
+
+        __atomic_store_n(&reload->seen, gen, __ATOMIC_RELEASE);
+        // no trie older than generation gen is in use any more
+
+        hdr_record(hist, (ticks + (end - i) / 2) / (end - i));
+
+    }
+
+    latency_sink += sum;
+
+}
+
+
+
+/// Keeps rebuilding and swapping in the trie.
+
+void * reload_thread(void * arg) {
+
+    Reload * reload = (Reload *) arg;
+
+    while (!__atomic_load_n(&reload->stop, __ATOMIC_ACQUIRE)) {
+
+        unsigned long long start = wkl_now_ns();
+        Trie fresh = load_trie(reload->work, reload->leaf_push, reload->jump);
+
+        if (fresh == NULL) {  // handles trie memory allocation error
+
+            fprintf(stderr, "error: failed to allocate memory for trie\n");
+            exit(EXIT_FAILURE);
+
+        }
+
+        Trie old = __atomic_exchange_n(&reload->current, fresh,
+            __ATOMIC_ACQ_REL);
+        size_t gen = __atomic_add_fetch(&reload->published, 1,
+            __ATOMIC_RELEASE);
+
+        while (__atomic_load_n(&reload->seen, __ATOMIC_ACQUIRE) < gen &&
+            !__atomic_load_n(&reload->stop, __ATOMIC_ACQUIRE))
+            sched_yield();
+        // stop is only set once the searcher has finished
+
+        ibt_destroy(old);
+
+        __atomic_add_fetch(&reload->reload_ns, wkl_now_ns() - start,
+            __ATOMIC_RELAXED);
+        __atomic_add_fetch(&reload->reloads, 1, __ATOMIC_RELEASE);
+
+    }
+
+    return NULL;
+
+}
+
+
+
+/// Writes a scenario summary.
+
+void report(FILE * out, const char * name, Hdr hist, double ticks_per_ns) {
+
+    fprintf(out, "  \"%s\": {\"lookups\": %llu, \"mean_ns\": %.1f, "
+        "\"p50_ns\": %.1f, \"p99_ns\": %.1f,\n    \"p99.9_ns\": %.1f, "
+        "\"max_ns\": %.1f", name, hdr_count(hist),
+        hdr_mean(hist) / ticks_per_ns,
+        (double) hdr_percentile(hist, 50) / ticks_per_ns,
+        (double) hdr_percentile(hist, 99) / ticks_per_ns,
+        (double) hdr_percentile(hist, 99.9) / ticks_per_ns,
+        (double) hdr_max(hist) / ticks_per_ns);
+
+}
+
+
+
+/// Program entry point.
+/// Loads a workload and writes search latency percentiles.
+///
+/// @param argc - number of command line arguments
+/// @param argv - command line arguments
+///
+/// @return EXIT_SUCCESS or EXIT_FAILURE if error occurs
+
+int main(int argc, char * argv[]) {
+
+    size_t rows = 0;
+    size_t queries = QUERIES;
+    size_t batch = 1;
+    int kind = WKL_UNIFORM;
+    double zipf_s = 0.99;
+    unsigned long long seed = 1;
+    char * json_name = NULL;
+    char leaf_push = 0;
+    char jump = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:q:B:k:z:s:o:lj")) != -1) {
+
+        switch (opt) {
+
+            case 'n':  // rows to generate, or the most to read from file
+                rows = (size_t) strtoull(optarg, NULL, 10);
+                break;
+
+            case 'q':  // queries timed per scenario
+                queries = (size_t) strtoull(optarg, NULL, 10);
+                break;
+
+            case 'B':  // lookups per timed batch
+                batch = (size_t) strtoull(optarg, NULL, 10);
+                break;
+
+            case 'k':  // query stream kind
+                kind = (optarg[0] == 'z') ? WKL_ZIPF :
+                    (optarg[0] == 's') ? WKL_SEQUENTIAL : WKL_UNIFORM;
+                break;
+
+            case 'z':  // skew of the Zipf stream
+                zipf_s = strtod(optarg, NULL);
+                break;
+
+            case 's':  // seed for rows and queries
+                seed = strtoull(optarg, NULL, 10);
+                break;
+
+            case 'o':  // write JSON here instead of standard output
+                json_name = optarg;
+                break;
+
+            case 'l':  // leaf-push every trie built
+                leaf_push = 1;
+                break;
+
+            case 'j':  // build the jump table for every trie built
+                jump = 1;
+                break;
+
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+
+        }
+
+    }
+
+    if (argc - optind > 1 || batch == 0 || queries == 0) {
+
+        fprintf(stderr, USAGE);
+        return EXIT_FAILURE;
+
+    }
+    // handles incorrect command arguments error
+
+    char * filename = (optind < argc) ? argv[optind] : NULL;
+    Workload work;
+
+    if (filename != NULL) {  // rows come from a place_ip CSV file
+
+        FILE * fp = fopen(filename, "r");
+
+        if (fp == NULL) {  // handles file error
+
+            perror(filename);
+            return EXIT_FAILURE;
+
+        }
+
+        work = wkl_read_csv(fp, rows);
+        fclose(fp);
+
+    } else {
+
+        work = wkl_synthetic((rows == 0) ? ROWS : rows, seed);
+
+    }
+
+    if (work == NULL || wkl_rows(work) == 0) {  // handles empty workload
+
+        fprintf(stderr, "error: no rows to load\n");
+        return EXIT_FAILURE;
+
+    }
+
+    ikey_t * keys = wkl_queries(work, kind, queries, zipf_s, seed + 1);
+    Hdr steady = hdr_create();
+    Hdr reloading = hdr_create();
+    Hdr warm = hdr_create();
+
+    Reload reload;
+    memset(&reload, 0, sizeof(Reload));
+    reload.work = work;
+    reload.leaf_push = leaf_push;
+    reload.jump = jump;
+    reload.current = load_trie(work, leaf_push, jump);
+
+    if (keys == NULL || steady == NULL || reloading == NULL || warm == NULL ||
+        reload.current == NULL) {  // handles memory allocation error
+
+        fprintf(stderr, "error: failed to allocate memory\n");
+        return EXIT_FAILURE;
+
+    }
+
+    FILE * out = stdout;
+
+    if (json_name != NULL && (out = fopen(json_name, "w")) == NULL) {
+
+        perror(json_name);
+        return EXIT_FAILURE;
+
+    }
+
+    double ticks_per_ns = calibrate_ticks();
+
+    run_queries(&reload, keys, (queries < WARMUP) ? queries : WARMUP, batch,
+        warm);
+    run_queries(&reload, keys, queries, batch, steady);
+    // steady state: nothing else running
+
+    pthread_t reloader;
+
+    if (pthread_create(&reloader, NULL, reload_thread, &reload) != 0) {
+
+        fprintf(stderr, "error: failed to start reload thread\n");
+        return EXIT_FAILURE;
+
+    }
+
+    do {  // repeats the stream until a reload has overlapped it
+
+        run_queries(&reload, keys, queries, batch, reloading);
+
+    } while (__atomic_load_n(&reload.reloads, __ATOMIC_ACQUIRE) < MINRELOADS);
+
+    __atomic_store_n(&reload.stop, 1, __ATOMIC_RELEASE);
+    pthread_join(reloader, NULL);
+
+    fprintf(out, "{\n  \"config\": {\"source\": \"%s\", \"rows\": %zu, "
+        "\"queries\": %zu, \"batch\": %zu, \"stream\": \"%s\",\n"
+        "    \"leaf_push\": %d, \"jump\": %d, \"ticks_per_ns\": %.4f},\n",
+        (filename != NULL) ? filename : "synthetic", wkl_rows(work), queries,
+        batch, WKL_STREAM_NAMES[kind], leaf_push, jump, ticks_per_ns);
+
+    report(out, "steady", steady, ticks_per_ns);
+    fprintf(out, "},\n");
+    report(out, "reload", reloading, ticks_per_ns);
+    fprintf(out, ",\n    \"reloads\": %zu, \"mean_reload_ms\": %.1f}\n}\n",
+        reload.reloads, (double) reload.reload_ns / 1e6 /
+        (double) reload.reloads);
+
+    if (out != stdout)
+        fclose(out);
+
+    ibt_destroy(reload.current);
+    hdr_destroy(steady);
+    hdr_destroy(reloading);
+    hdr_destroy(warm);
+    free(keys);
+    wkl_destroy(work);
+
+    return EXIT_SUCCESS;
+
+}
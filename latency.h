@@ -0,0 +1,133 @@
+// File: latency.h
+//
+// Description: function declarations and constants for the latency module
+//
+// @author: Max Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef LATENCY
+#define LATENCY
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sched.h>
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "trie.h"
+#include "workload.h"
+#include "hdr.h"
+
+#define CALIBRATE_NS 50000000ULL
+// time spent measuring the tick rate
+
+#define WARMUP 100000
+// most queries run untimed before each scenario
+
+#define MINRELOADS 1
+// reloads the reload scenario waits for before it stops
+
+
+
+/// Reload is the state shared between the searching thread and the
+/// reloading thread. There is one searching thread: after each batch it
+/// reports the generation it saw, and the reloader frees a replaced trie
+/// only once that generation shows the searcher has moved past it.
+struct Reload_s {
+
+    Workload work;
+    char leaf_push;
+    char jump;
+    // how each trie is built
+
+    Trie current;
+    // the trie searches use (atomic)
+
+    size_t published;
+    size_t seen;
+    // generation of current, and the one the searcher last started with
+    // (atomic)
+
+    int stop;
+    // set once the searcher is done (atomic)
+
+    size_t reloads;
+    unsigned long long reload_ns;
+    // completed reloads and their total build time (atomic)
+
+};
+
+
+
+/// Defines Reload as the (stack allocatable) shared state struct.
+typedef struct Reload_s Reload;
+
+
+
+/// Builds a trie holding both bounds of every workload row.
+///
+/// @param work - the rows to load
+/// @param leaf_push - whether to leaf-push the trie
+/// @param jump - whether to build the jump table
+///
+/// @return the trie, or NULL on failure
+
+Trie load_trie(Workload work, char leaf_push, char jump);
+
+
+
+/// Measures how many timer ticks pass per nanosecond.
+///
+/// @return ticks per nanosecond
+
+double calibrate_ticks(void);
+
+
+
+/// Times a query stream in batches, recording the ticks per lookup of
+/// each batch.
+///
+/// @param reload - the shared state holding the trie (passed as pointer)
+/// @param keys - the query keys
+/// @param count - the number of keys
+/// @param batch - lookups per timed batch
+/// @param hist - the histogram receiving per-lookup ticks
+
+void run_queries(Reload * reload, ikey_t * keys, size_t count, size_t batch,
+    Hdr hist);
+
+
+
+/// Rebuilds the trie from the workload until told to stop, swapping each
+/// new trie in and freeing the old one once the searcher is past it.
+///
+/// @param arg - the shared state (a Reload pointer)
+///
+/// @return NULL
+
+void * reload_thread(void * arg);
+
+
+
+/// Writes one scenario's latency summary as a JSON member.
+///
+/// @param out - the output stream
+/// @param name - the scenario name
+/// @param hist - the histogram of per-lookup ticks
+/// @param ticks_per_ns - the tick rate
+
+void report(FILE * out, const char * name, Hdr hist, double ticks_per_ns);
+
+
+
+#endif  // LATENCY
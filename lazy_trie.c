@@ -0,0 +1,297 @@
+// File: lazy_trie.c
+//
+// Description: module for a trie built lazily, one /8 subtrie at a time
+//
+// Keys are split by their top byte into 256 blocks, each with its own
+// Trie, built on first touch from the rows noted for it. Every key in a
+// block shares the top 8 bits with any query in that block, so it is
+// closer by the trie's rule than any key outside; a query into a
+// non-empty block is thus answered by that block alone. A query into an
+// empty block goes to the largest key below or the smallest key above,
+// which are tracked per block while noting.
+//
+// Each block is built at most once: a ready flag is read with acquire
+// ordering and, when clear, rechecked under the block's mutex by the one
+// thread that then builds it.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "lazy_trie.h"
+
+
+
+#define BLOCKS 256
+// one block per /8
+
+
+#define BLOCKSHIFT 24
+// key bits below the block number
+
+
+
+/// Block_s holds the rows noted for one /8 and, once built, its Trie.
+struct Block_s {
+
+    long * rows;
+    size_t num_rows;
+    size_t cap;
+    // noted rows
+
+    size_t keys;
+    ikey_t min;
+    ikey_t max;
+    // keys noted, and the smallest and largest of them
+
+    Trie trie;
+    int ready;
+    pthread_mutex_t lock;
+    // built Trie, its once-flag, and the lock its builder holds
+
+};
+
+
+
+/// Defines the struct for the LazyTrie ADT
+struct LazyTrie_s {
+
+    struct Block_s blocks[BLOCKS];
+
+    size_t keys;
+    size_t built;
+
+    void (*load)(Trie trie, unsigned int block, long row, void * context);
+    void * context;
+    // user-passed row loader
+
+    void (*ibt_show_value_w)(Entry entry, FILE * stream);
+    void (*ibt_delete_entry)(Entry entry);
+    // user-passed Trie functions for every block
+
+};
+
+
+
+/// Creates and returns an empty LazyTrie instance.
+
+LazyTrie lzy_create(void (*load)(Trie trie, unsigned int block, long row,
+    void * context), void * context,
+    void (*ext_show_value)(Entry entry, FILE * stream),
+    void (*ext_delete_entry)(Entry entry)) {
+
+    LazyTrie lazy = (LazyTrie) calloc(1, sizeof(struct LazyTrie_s));
+
+    if (lazy == NULL)  // signifies an allocation failure
+        return NULL;
+
+    for (size_t b = 0; b < BLOCKS; b++)
+        pthread_mutex_init(&lazy->blocks[b].lock, NULL);
+
+    lazy->load = load;
+    lazy->context = context;
+    lazy->ibt_show_value_w = ext_show_value;
+    lazy->ibt_delete_entry = ext_delete_entry;
+
+    return lazy;
+
+}
+
+
+
+/// Frees every block and the LazyTrie.
+
+void lzy_destroy(LazyTrie lazy) {
+
+    for (size_t b = 0; b < BLOCKS; b++) {
+
+        if (lazy->blocks[b].trie != NULL)
+            ibt_destroy(lazy->blocks[b].trie);
+
+        free(lazy->blocks[b].rows);
+        pthread_mutex_destroy(&lazy->blocks[b].lock);
+
+    }
+
+    free(lazy);
+
+}
+
+
+
+/// Notes a row holding a key.
+
+int lzy_note(LazyTrie lazy, ikey_t key, long row) {
+
+    struct Block_s * block = &lazy->blocks[key >> BLOCKSHIFT];
+
+    if (block->keys == 0 || key < block->min)
+        block->min = key;
+
+    if (block->keys == 0 || key > block->max)
+        block->max = key;
+
+    block->keys++;
+    lazy->keys++;
+
+    if (block->num_rows > 0 && block->rows[block->num_rows - 1] == row)
+        return 1;
+    // the row's other key already noted it
+
+    if (block->num_rows == block->cap) {  // grows the row array
+
+        size_t cap = (block->cap == 0) ? 64 : block->cap * 2;
+        long * rows = (long *) realloc(block->rows, cap * sizeof(long));
+
+        if (rows == NULL)  // signifies an allocation failure
+            return 0;
+
+        block->rows = rows;
+        block->cap = cap;
+
+    }
+
+    block->rows[block->num_rows++] = row;
+
+    return 1;
+
+}
+
+
+
+/// Builds a block's Trie on first touch.
+///
+/// @param lazy - the LazyTrie instance
+/// @param b - the block number
+///
+/// @return the block's Trie
+
+static Trie lzy_block(LazyTrie lazy, unsigned int b) {
+
+    struct Block_s * block = &lazy->blocks[b];
+
+#ifdef __GNUC__
+
+    if (__atomic_load_n(&block->ready, __ATOMIC_ACQUIRE))  // already built
+        return block->trie;
+
+#endif
+
+    pthread_mutex_lock(&block->lock);
+
+    if (!block->ready) {  // this thread builds the block
+
+        Trie trie = ibt_create(lazy->ibt_show_value_w, lazy->ibt_delete_entry);
+
+        if (trie == NULL) {  // handles trie memory allocation error
+
+            fprintf(stderr, "error: failed to allocate memory for trie\n");
+            exit(EXIT_FAILURE);
+
+        }
+
+        for (size_t i = 0; i < block->num_rows; i++)
+            lazy->load(trie, b, block->rows[i], lazy->context);
+
+        block->trie = trie;
+
+#ifdef __GNUC__
+
+        __atomic_fetch_add(&lazy->built, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&block->ready, 1, __ATOMIC_RELEASE);
+
+#else
+
+        lazy->built++;
+        block->ready = 1;
+
+#endif
+
+    }
+
+    pthread_mutex_unlock(&block->lock);
+
+    return block->trie;
+
+}
+
+
+
+/// Searches the block that holds the closest match.
+
+Entry lzy_search(LazyTrie lazy, ikey_t key) {
+
+    if (lazy->keys == 0) {  // handles unexpected empty trie error
+
+        fprintf(stderr, "error: cannot query an empty trie\n");
+        lzy_destroy(lazy);
+
+        exit(EXIT_FAILURE);
+
+    }
+
+    unsigned int b = key >> BLOCKSHIFT;
+
+    if (lazy->blocks[b].keys > 0)  // the block holds the answer
+        return ibt_search(lzy_block(lazy, b), key);
+
+    int below = (int) b - 1;
+    unsigned int above = b + 1;
+
+    while (below >= 0 && lazy->blocks[below].keys == 0)
+        below--;
+
+    while (above < BLOCKS && lazy->blocks[above].keys == 0)
+        above++;
+    // nearest non-empty blocks on each side
+
+    unsigned int target;
+    ikey_t closest;
+
+    if (above == BLOCKS || (below >= 0 &&
+        (lazy->blocks[below].max ^ key) <= (lazy->blocks[above].min ^ key))) {
+
+        target = (unsigned int) below;
+        closest = lazy->blocks[below].max;
+
+    } else {
+
+        target = above;
+        closest = lazy->blocks[above].min;
+
+    }
+    // the predecessor or successor sharing the longer prefix, as in the trie
+
+    return ibt_search(lzy_block(lazy, target), closest);
+
+}
+
+
+
+/// Fetches the noted key count.
+
+size_t lzy_keys(LazyTrie lazy) {
+
+    return lazy->keys;
+
+}
+
+
+
+/// Fetches the built block count.
+
+size_t lzy_built(LazyTrie lazy) {
+
+#ifdef __GNUC__
+
+    return __atomic_load_n(&lazy->built, __ATOMIC_RELAXED);
+
+#else
+
+    return lazy->built;
+
+#endif
+
+}
@@ -0,0 +1,102 @@
+// File: lazy_trie.h
+//
+// Description: header for a trie built lazily, one /8 subtrie at a time
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef LAZY_TRIE_H
+#define LAZY_TRIE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "trie.h"
+
+
+
+/// LazyTrie is a pointer to the LazyTrie ADT.
+typedef struct LazyTrie_s * LazyTrie;
+
+
+
+/// Create an empty LazyTrie. Rows are only noted (by their position in
+/// some source, such as a file offset) until a search first touches their
+/// /8 block; load is then called once per noted row of the block to insert
+/// that row's keys in the block into the block's Trie. Loads of different
+/// blocks may run at the same time on different threads.
+///
+/// @param load - inserts a row's keys inside a block into a Trie
+/// @param context - passed through to load
+/// @param ext_show_value - the Trie display function for every block
+/// @param ext_delete_entry - the Trie entry free function for every block
+///
+/// @return pointer to the LazyTrie instance or NULL on failure
+
+LazyTrie lzy_create(void (*load)(Trie trie, unsigned int block, long row,
+    void * context), void * context,
+    void (*ext_show_value)(Entry entry, FILE * stream),
+    void (*ext_delete_entry)(Entry entry));
+
+
+
+/// Destroy the LazyTrie and every block Trie built so far.
+///
+/// @param lazy - a pointer to a LazyTrie instance
+
+void lzy_destroy(LazyTrie lazy);
+
+
+
+/// Note that a row holds a key. A row whose keys fall in two blocks is
+/// noted once per block; noting consecutive keys of one row in the same
+/// block records the row once.
+///
+/// @param lazy - a pointer to a LazyTrie instance
+/// @param key - the key
+/// @param row - the row's position, passed to load
+///
+/// @return 1 on success, 0 on allocation failure
+
+int lzy_note(LazyTrie lazy, ikey_t key, long row);
+
+
+
+/// Search for the closest entry that matches key, giving the same answer
+/// as ibt_search on a Trie holding every key. Builds the block holding
+/// the answer on first touch; safe to call from several threads.
+///
+/// @param lazy - a pointer to a non-empty LazyTrie instance
+/// @param key - the key to find
+///
+/// @return the closest matching entry
+
+Entry lzy_search(LazyTrie lazy, ikey_t key);
+
+
+
+/// Get the number of keys noted.
+///
+/// @param lazy - a pointer to a LazyTrie instance
+///
+/// @return the count of keys noted (duplicates included)
+
+size_t lzy_keys(LazyTrie lazy);
+
+
+
+/// Get the number of blocks built so far.
+///
+/// @param lazy - a pointer to a LazyTrie instance
+///
+/// @return the count of /8 subtries materialized
+
+size_t lzy_built(LazyTrie lazy);
+
+
+
+#endif  // LAZY_TRIE_H
@@ -0,0 +1,472 @@
+// File: lulea.c
+//
+// Description: module for a Lulea-style compressed three-level lookup table
+//
+// The key is split 16/8/8. Each level is a conceptual array of slots
+// (65536 at level 1, 256 per chunk below) holding either a range index or
+// a pointer to a chunk at the next level. Runs of equal slots are stored
+// once: a head bitmap marks the slots where the value changes, packed in
+// 16-bit codewords, each with the count of heads earlier in its group of
+// four codewords; one base index per group locates the group's values.
+// A slot's value is then
+//
+//     vals[base[slot / 64] + code[slot / 16].offset +
+//          popcount(code[slot / 16].bits up to slot) - 1]
+//
+// which costs three memory accesses per level. Classic Lulea decodes the
+// head bits through a maptable of the few bit patterns a prefix tree can
+// produce; arbitrary ranges produce any pattern, so a popcount of the
+// codeword's bits takes the maptable's place.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "lulea.h"
+
+
+
+#define L1SLOTS   65536
+#define CHUNKSLOTS  256
+// slots per level 1 table and per lower chunk
+
+
+#define SLOTSPERCODE 16
+#define CODESPERBASE 4
+// head bits per codeword and codewords per base index
+
+
+#define CHUNKTAG  (1u << 31)
+#define NOVALUE   (CHUNKTAG - 1)
+// slot value tags: chunk pointer, or no containing range
+
+
+
+/// Code_s is a codeword: a 16-slot head bitmap and the heads before it
+/// in its group.
+struct Code_s {
+
+    unsigned short bits;
+    unsigned short offset;
+
+};
+
+
+
+/// Defines the struct for the Lulea ADT
+struct Lulea_s {
+
+    struct Code_s * codes;
+    size_t num_codes;
+    size_t code_cap;
+    // codewords: level 1 first, then 16 per chunk
+
+    unsigned int * bases;
+    size_t num_bases;
+    size_t base_cap;
+    // base indices: level 1 first, then 4 per chunk
+
+    unsigned int * vals;
+    size_t num_vals;
+    size_t val_cap;
+    // slot values at heads, for every level
+
+    size_t num_chunks;
+
+};
+
+
+
+/// Lulea build state shared across levels.
+struct Build_s {
+
+    Ranges ranges;
+    ikey_t * breaks;
+    size_t num_breaks;
+    // sorted keys at which the containing range changes
+
+    char failed;
+    // set when a table array could not grow; the build then unwinds
+
+};
+
+
+
+/// Grows a dynamic array to hold at least need elements.
+///
+/// @param array - the array (passed as pointer)
+/// @param cap - the capacity (passed as pointer)
+/// @param need - the required element count
+/// @param size - the element size
+///
+/// @return 1 on success, 0 on memory error (array and capacity unchanged)
+
+static int lulea_reserve(void ** array, size_t * cap, size_t need,
+    size_t size) {
+
+    if (need <= *cap)
+        return 1;
+
+    size_t grown = *cap;
+
+    while (grown < need)
+        grown = (grown == 0) ? 1024 : grown * 2;
+
+    void * block = realloc(*array, grown * size);
+
+    if (block == NULL)  // handles memory error, keeps the old block
+        return 0;
+
+    *array = block;
+    *cap = grown;
+
+    return 1;
+
+}
+
+
+
+/// Checks whether the containing range changes strictly inside a block.
+///
+/// @param build - the build state
+/// @param start - the first key of the block
+/// @param len - the number of keys in the block
+///
+/// @return 1 if the block is split, 0 if one value covers it
+
+static int lulea_split(struct Build_s * build, unsigned long long start,
+    unsigned long long len) {
+
+    size_t lo = 0;
+    size_t hi = build->num_breaks;
+
+    while (lo < hi) {  // finds the first break above start
+
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (build->breaks[mid] <= start)
+            lo = mid + 1;
+        else
+            hi = mid;
+
+    }
+
+    return lo < build->num_breaks && build->breaks[lo] < start + len;
+
+}
+
+
+
+/// Gets the slot value of a uniform block from its first key.
+///
+/// @param build - the build state
+/// @param key - the first key of the block
+///
+/// @return the range index or NOVALUE
+
+static unsigned int lulea_value(struct Build_s * build, ikey_t key) {
+
+    size_t index = rng_find(build->ranges, key);
+
+    return (index == RNG_NONE) ? NOVALUE : (unsigned int) index;
+
+}
+
+
+
+/// Stores one level's slot values as codewords, base indices and heads.
+///
+/// @param table - the Lulea instance
+/// @param slots - the slot values
+/// @param count - the number of slots (a multiple of 64)
+/// @param code0 - position of the level's first codeword
+/// @param base0 - position of the level's first base index
+///
+/// @return 1 on success, 0 on memory error
+
+static int lulea_encode(Lulea table, unsigned int * slots, size_t count,
+    size_t code0, size_t base0) {
+
+    unsigned short offset = 0;
+
+    for (size_t w = 0; w < count / SLOTSPERCODE; w++) {  // one codeword each
+
+        if (w % CODESPERBASE == 0) {  // starts a new group
+
+            table->bases[base0 + w / CODESPERBASE] =
+                (unsigned int) table->num_vals;
+            offset = 0;
+
+        }
+
+        unsigned short bits = 0;
+
+        for (size_t b = 0; b < SLOTSPERCODE; b++) {  // marks heads
+
+            size_t i = w * SLOTSPERCODE + b;
+
+            if (i == 0 || slots[i] != slots[i - 1]) {
+
+                bits |= (unsigned short) (1u << b);
+
+                if (!lulea_reserve((void **) &table->vals, &table->val_cap,
+                    table->num_vals + 1, sizeof(unsigned int)))
+                    return 0;
+
+                table->vals[table->num_vals++] = slots[i];
+
+            }
+
+        }
+
+        table->codes[code0 + w].bits = bits;
+        table->codes[code0 + w].offset = offset;
+
+        for (unsigned short rest = bits; rest != 0; rest &= rest - 1)
+            offset++;
+
+    }
+
+    return 1;
+
+}
+
+
+
+/// Builds the chunk for a block of CHUNKSLOTS sub-blocks.
+///
+/// @param table - the Lulea instance
+/// @param build - the build state
+/// @param start - the first key of the block
+/// @param shift - log2 of the keys per sub-block (8 or 0)
+///
+/// @return the chunk index (0 with build->failed set on memory error)
+
+static unsigned int lulea_chunk(Lulea table, struct Build_s * build,
+    unsigned long long start, unsigned int shift) {
+
+    unsigned int chunk = (unsigned int) table->num_chunks++;
+    size_t code0 = table->num_codes;
+    size_t base0 = table->num_bases;
+
+    table->num_codes += CHUNKSLOTS / SLOTSPERCODE;
+    table->num_bases += CHUNKSLOTS / SLOTSPERCODE / CODESPERBASE;
+
+    if (!lulea_reserve((void **) &table->codes, &table->code_cap,
+        table->num_codes, sizeof(struct Code_s)) ||
+        !lulea_reserve((void **) &table->bases, &table->base_cap,
+        table->num_bases, sizeof(unsigned int))) {
+
+        build->failed = 1;
+        return 0;
+
+    }
+    // reserves this chunk's codewords before any sub-chunk's
+
+    unsigned int slots[CHUNKSLOTS];
+
+    for (size_t i = 0; i < CHUNKSLOTS; i++) {  // fills sub-block values
+
+        unsigned long long sub = start + (i << shift);
+
+        if (shift > 0 && lulea_split(build, sub, 1ULL << shift)) {
+
+            slots[i] = CHUNKTAG | lulea_chunk(table, build, sub, 0);
+
+            if (build->failed)  // unwinds after a memory error
+                return 0;
+
+        } else {
+
+            slots[i] = lulea_value(build, (ikey_t) sub);
+
+        }
+
+    }
+
+    if (!lulea_encode(table, slots, CHUNKSLOTS, code0, base0))
+        build->failed = 1;
+
+    return chunk;
+
+}
+
+
+
+/// Frees all storage used by the table.
+
+void lulea_destroy(Lulea table) {
+
+    free(table->codes);
+    free(table->bases);
+    free(table->vals);
+    free(table);
+
+}
+
+
+
+/// Builds the Lulea table from normalized ranges.
+
+Lulea lulea_build(Ranges ranges) {
+
+    Lulea table = (Lulea) calloc(1, sizeof(struct Lulea_s));
+
+    if (table == NULL)  // signifies an allocation failure
+        return NULL;
+
+    struct Build_s build;
+    struct Range_s * items = rng_items(ranges);
+
+    build.ranges = ranges;
+    build.num_breaks = 0;
+    build.failed = 0;
+    build.breaks = (ikey_t *) malloc((2 * rng_count(ranges) + 1) *
+        sizeof(ikey_t));
+
+    unsigned int * slots = (unsigned int *) malloc(L1SLOTS *
+        sizeof(unsigned int));
+
+    if (build.breaks == NULL || slots == NULL) {  // allocation failure
+
+        free(build.breaks);
+        free(slots);
+        lulea_destroy(table);
+
+        return NULL;
+
+    }
+
+    for (size_t i = 0; i < rng_count(ranges); i++) {  // collects range edges
+
+        build.breaks[build.num_breaks++] = items[i].lo;
+
+        if (items[i].hi != (ikey_t) -1)
+            build.breaks[build.num_breaks++] = items[i].hi + 1;
+
+    }
+    // normalized ranges are sorted and disjoint, so edges are ascending
+
+    table->num_codes = L1SLOTS / SLOTSPERCODE;
+    table->num_bases = L1SLOTS / SLOTSPERCODE / CODESPERBASE;
+
+    build.failed = !lulea_reserve((void **) &table->codes, &table->code_cap,
+        table->num_codes, sizeof(struct Code_s)) ||
+        !lulea_reserve((void **) &table->bases, &table->base_cap,
+        table->num_bases, sizeof(unsigned int));
+
+    for (size_t i = 0; i < L1SLOTS && !build.failed; i++) {  // level 1
+
+        unsigned long long start = (unsigned long long) i << 16;
+
+        if (lulea_split(&build, start, 1ULL << 16)) {
+
+            slots[i] = CHUNKTAG | lulea_chunk(table, &build, start, 8);
+
+        } else {
+
+            slots[i] = lulea_value(&build, (ikey_t) start);
+
+        }
+
+    }
+
+    if (!build.failed && !lulea_encode(table, slots, L1SLOTS, 0, 0))
+        build.failed = 1;
+
+    free(build.breaks);
+    free(slots);
+
+    if (build.failed) {  // handles memory error
+
+        lulea_destroy(table);
+        return NULL;
+
+    }
+
+    return table;
+
+}
+
+
+
+/// Reads one slot value of a level.
+///
+/// @param table - the Lulea instance
+/// @param code0 - position of the level's first codeword
+/// @param base0 - position of the level's first base index
+/// @param slot - the slot within the level
+///
+/// @return the slot value
+
+static unsigned int lulea_slot(Lulea table, size_t code0, size_t base0,
+    unsigned int slot) {
+
+    struct Code_s code = table->codes[code0 + slot / SLOTSPERCODE];
+    unsigned int bits = code.bits & ((2u << (slot % SLOTSPERCODE)) - 1);
+
+#ifdef __GNUC__
+
+    unsigned int heads = (unsigned int) __builtin_popcount(bits);
+
+#else
+
+    unsigned int heads = 0;
+
+    for (; bits != 0; bits &= bits - 1)
+        heads++;
+
+#endif
+
+    return table->vals[table->bases[base0 +
+        slot / (SLOTSPERCODE * CODESPERBASE)] + code.offset + heads - 1];
+
+}
+
+
+
+/// Looks up a key level by level.
+
+size_t lulea_lookup(Lulea table, ikey_t key) {
+
+    unsigned int value = lulea_slot(table, 0, 0, key >> 16);
+
+    for (unsigned int shift = 8; value & CHUNKTAG; shift -= 8) {  // descends
+
+        size_t chunk = value & ~CHUNKTAG;
+
+        value = lulea_slot(table,
+            L1SLOTS / SLOTSPERCODE + chunk * (CHUNKSLOTS / SLOTSPERCODE),
+            L1SLOTS / SLOTSPERCODE / CODESPERBASE +
+                chunk * (CHUNKSLOTS / SLOTSPERCODE / CODESPERBASE),
+            (key >> shift) & (CHUNKSLOTS - 1));
+
+    }
+
+    return (value == NOVALUE) ? RNG_NONE : value;
+
+}
+
+
+
+/// Fetches the chunk count.
+
+size_t lulea_chunk_count(Lulea table) {
+
+    return table->num_chunks;
+
+}
+
+
+
+/// Computes the bytes used by the table.
+
+size_t lulea_memory(Lulea table) {
+
+    return table->num_codes * sizeof(struct Code_s) +
+        table->num_bases * sizeof(unsigned int) +
+        table->num_vals * sizeof(unsigned int);
+
+}
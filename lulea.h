@@ -0,0 +1,79 @@
+// File: lulea.h
+//
+// Description: header for a Lulea-style compressed three-level lookup table
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef LULEA_H
+#define LULEA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+#include "ranges.h"
+
+
+
+/// Lulea is a pointer to the Lulea ADT.
+typedef struct Lulea_s * Lulea;
+
+
+
+/// Build a read-only Lulea table mapping every key to its range.
+/// Levels split the key 16/8/8; each level stores only the slots where
+/// the answer changes, located by a bitmap codeword and base index.
+///
+/// @param ranges - a pointer to a normalized Ranges instance
+///     (at most 2^31 - 2 ranges)
+///
+/// @return pointer to the Lulea instance or NULL on failure
+
+Lulea lulea_build(Ranges ranges);
+
+
+
+/// Destroy the table and free all storage (the Ranges are not touched).
+///
+/// @param table - a pointer to a Lulea instance
+
+void lulea_destroy(Lulea table);
+
+
+
+/// Find the range containing key in at most three levels.
+///
+/// @param table - a pointer to a Lulea instance
+/// @param key - the key to find
+///
+/// @return the index of the containing range or RNG_NONE
+
+size_t lulea_lookup(Lulea table, ikey_t key);
+
+
+
+/// Get the number of level 2 and level 3 chunks.
+///
+/// @param table - a pointer to a Lulea instance
+///
+/// @return the chunk count
+
+size_t lulea_chunk_count(Lulea table);
+
+
+
+/// Get the bytes used by the table.
+///
+/// @param table - a pointer to a Lulea instance
+///
+/// @return total size of codewords, base indices and values in bytes
+
+size_t lulea_memory(Lulea table);
+
+
+
+#endif  // LULEA_H
@@ -0,0 +1,255 @@
+// File: perf_counters.c
+//
+// Description: module for hardware performance counters read through the
+// Linux perf_event_open system call
+//
+// Each counter is opened on its own rather than as one group, so a CPU
+// or virtual machine lacking one event still reports the rest. Reads ask
+// for the enabled and running times, and counts are scaled by their
+// ratio when the kernel multiplexed more events than there are hardware
+// counters.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#define _DEFAULT_SOURCE
+// exposes syscall
+
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "perf_counters.h"
+
+
+
+/// Defines the struct for the Counters ADT
+struct Counters_s {
+
+    int fd[PFC_EVENTS];
+    // counter file descriptors, or -1 if unavailable
+
+    unsigned long long value[PFC_EVENTS];
+    // scaled counts from the last measured span
+
+};
+
+
+
+const char * PFC_NAMES[] = { "cycles", "instructions", "l1d_misses",
+    "llc_misses", "dtlb_misses", "branch_misses" };
+
+
+
+#ifdef __linux__
+
+/// Builds the perf_event_open configuration of a hardware cache read miss.
+///
+/// @param cache - the PERF_COUNT_HW_CACHE_* cache identifier
+///
+/// @return the event configuration
+
+static unsigned long long pfc_cache_miss(unsigned long long cache) {
+
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+}
+
+
+
+/// Opens one counter for the calling thread.
+///
+/// @param type - the PERF_TYPE_* event type
+/// @param config - the event configuration
+///
+/// @return the file descriptor, or -1 on failure
+
+static int pfc_open_event(unsigned int type, unsigned long long config) {
+
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+        PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // user space only, which perf_event_paranoid up to 2 allows
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+
+}
+
+#endif
+
+
+
+/// Opens every counter it can.
+
+Counters pfc_open(void) {
+
+    Counters counters = (Counters) malloc(sizeof(struct Counters_s));
+
+    if (counters == NULL)  // signifies an allocation failure
+        return NULL;
+
+    for (int e = 0; e < PFC_EVENTS; e++) {
+
+        counters->fd[e] = -1;
+        counters->value[e] = 0;
+
+    }
+
+#ifdef __linux__
+
+    counters->fd[PFC_CYCLES] = pfc_open_event(PERF_TYPE_HARDWARE,
+        PERF_COUNT_HW_CPU_CYCLES);
+    counters->fd[PFC_INSTRUCTIONS] = pfc_open_event(PERF_TYPE_HARDWARE,
+        PERF_COUNT_HW_INSTRUCTIONS);
+    counters->fd[PFC_L1D_MISSES] = pfc_open_event(PERF_TYPE_HW_CACHE,
+        pfc_cache_miss(PERF_COUNT_HW_CACHE_L1D));
+    counters->fd[PFC_LLC_MISSES] = pfc_open_event(PERF_TYPE_HW_CACHE,
+        pfc_cache_miss(PERF_COUNT_HW_CACHE_LL));
+    counters->fd[PFC_DTLB_MISSES] = pfc_open_event(PERF_TYPE_HW_CACHE,
+        pfc_cache_miss(PERF_COUNT_HW_CACHE_DTLB));
+    counters->fd[PFC_BRANCH_MISSES] = pfc_open_event(PERF_TYPE_HARDWARE,
+        PERF_COUNT_HW_BRANCH_MISSES);
+
+#endif
+
+    return counters;
+
+}
+
+
+
+/// Closes the counters.
+
+void pfc_close(Counters counters) {
+
+    for (int e = 0; e < PFC_EVENTS; e++)
+        if (counters->fd[e] >= 0)
+            close(counters->fd[e]);
+
+    free(counters);
+
+}
+
+
+
+/// Checks whether a counter was opened.
+
+int pfc_available(Counters counters, int event) {
+
+    return counters->fd[event] >= 0;
+
+}
+
+
+
+/// Zeroes and starts the counters.
+
+void pfc_start(Counters counters) {
+
+#ifdef __linux__
+
+    for (int e = 0; e < PFC_EVENTS; e++)
+        if (counters->fd[e] >= 0) {
+
+            ioctl(counters->fd[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(counters->fd[e], PERF_EVENT_IOC_ENABLE, 0);
+
+        }
+
+#else
+
+    (void) counters;
+
+#endif
+
+}
+
+
+
+/// Stops and reads the counters.
+
+void pfc_stop(Counters counters) {
+
+#ifdef __linux__
+
+    for (int e = 0; e < PFC_EVENTS; e++)
+        if (counters->fd[e] >= 0)
+            ioctl(counters->fd[e], PERF_EVENT_IOC_DISABLE, 0);
+    // stops them all before reading any
+
+    for (int e = 0; e < PFC_EVENTS; e++) {
+
+        unsigned long long data[3];
+        // count, time enabled, time running
+
+        counters->value[e] = 0;
+
+        if (counters->fd[e] < 0 ||
+            read(counters->fd[e], data, sizeof(data)) != sizeof(data))
+            continue;
+
+        if (data[2] != 0 && data[2] < data[1])  // scales a multiplexed count
+            counters->value[e] = (unsigned long long) ((double) data[0] *
+                (double) data[1] / (double) data[2]);
+        else
+            counters->value[e] = data[0];
+
+    }
+
+#else
+
+    (void) counters;
+
+#endif
+
+}
+
+
+
+/// Fetches a counter's last count.
+
+unsigned long long pfc_value(Counters counters, int event) {
+
+    return counters->value[event];
+
+}
+
+
+
+/// Writes the per-operation counts as JSON.
+
+void pfc_show(Counters counters, double ops, FILE * stream) {
+
+    fprintf(stream, "{");
+
+    for (int e = 0; e < PFC_EVENTS; e++) {
+
+        fprintf(stream, "%s\"%s\": ", (e == 0) ? "" : ", ", PFC_NAMES[e]);
+
+        if (counters->fd[e] < 0 || ops <= 0)  // nothing measured
+            fprintf(stream, "null");
+        else
+            fprintf(stream, "%.3f", (double) counters->value[e] / ops);
+
+    }
+
+    fprintf(stream, "}");
+
+}
@@ -0,0 +1,110 @@
+// File: perf_counters.h
+//
+// Description: header for a hardware performance counter ADT (Linux
+// perf_event_open) used to measure benchmark phases
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+
+/// Counters is a pointer to the Counters ADT.
+typedef struct Counters_s * Counters;
+
+
+
+#define PFC_CYCLES 0
+#define PFC_INSTRUCTIONS 1
+#define PFC_L1D_MISSES 2
+#define PFC_LLC_MISSES 3
+#define PFC_DTLB_MISSES 4
+#define PFC_BRANCH_MISSES 5
+// counter indices
+
+#define PFC_EVENTS 6
+// number of counters
+
+
+
+extern const char * PFC_NAMES[];        /// < counter names, by index
+
+
+
+/// Open every counter for the calling thread, user space only. A counter
+/// the kernel or CPU cannot provide (no PMU, perf_event_paranoid too high,
+/// not Linux) is marked unavailable and the others still work.
+///
+/// @return pointer to the Counters instance or NULL on failure
+
+Counters pfc_open(void);
+
+
+
+/// Close the counters.
+///
+/// @param counters - a pointer to a Counters instance
+
+void pfc_close(Counters counters);
+
+
+
+/// Check whether a counter could be opened.
+///
+/// @param counters - a pointer to a Counters instance
+/// @param event - the counter index
+///
+/// @return 1 if the counter works, else 0
+
+int pfc_available(Counters counters, int event);
+
+
+
+/// Zero and start every available counter.
+///
+/// @param counters - a pointer to a Counters instance
+
+void pfc_start(Counters counters);
+
+
+
+/// Stop every available counter and read it.
+///
+/// @param counters - a pointer to a Counters instance
+
+void pfc_stop(Counters counters);
+
+
+
+/// Get a counter's count between the last pfc_start and pfc_stop, scaled
+/// up if the kernel had to share the hardware counter with other events.
+///
+/// @param counters - a pointer to a Counters instance
+/// @param event - the counter index
+///
+/// @return the count, or 0 if unavailable
+
+unsigned long long pfc_value(Counters counters, int event);
+
+
+
+/// Write the counts divided by an operation count as a JSON object,
+/// with null for unavailable counters.
+///
+/// @param counters - a pointer to a Counters instance
+/// @param ops - the number of operations measured
+/// @param stream - the output stream
+
+void pfc_show(Counters counters, double ops, FILE * stream);
+
+
+
+#endif  // PERF_COUNTERS_H
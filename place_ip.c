@@ -15,8 +15,18 @@
 // the number of additional country datapoints provided in CSV file 
 
 
-#define IPV4STR   15
-// IPV4 string length maximum
+#define VALFORMAT "\"%511[^\"]\",\"%511[^\"]\",\"%511[^\"]\",\"%511[^\"]\""
+// stored value format; field widths are BUFLEN - 1
+
+
+#define PREFAULT (64 * 1024)
+// stack bytes touched before serving in deterministic mode
+
+
+#define USAGE "usage: place_ip [-l] [-j] [-d levels] [-m bytes] " \
+    "[-p period] [-H] [-P] [-L] [-D] [-z] [-b] [-c capture_file] " \
+    "[-6 ipv6_filename] filename\n"
+// command usage message
 
 
 
@@ -41,16 +51,30 @@ ikey_t ipv4_to_num(char ip[BUFLEN]) {
 /// Converts unsigned integer (ikey_t) IP representation to "dotted" string.
 
 char * num_to_ipv4(ikey_t num) {
+
+    char * result = (char *) calloc(IPV4STR + 1, sizeof(char));
+
+    if (result != NULL)
+        num_to_ipv4_r(num, result);
+
+    return result;
+
+}
+
+
+
+/// Writes the "dotted" string of an IP into a caller-supplied buffer.
+
+void num_to_ipv4_r(ikey_t num, char result[IPV4STR + 1]) {
  
     ikey_t mask = RADIX - 1;
 
     unsigned char bytes[4];
-    char * result = (char *) calloc(IPV4STR + 1, sizeof(char));
 
     if (num == (ikey_t) -1) {
 
         strcpy(result, "INVALID");
-        return result;
+        return;
 
     }
     // returns the string "INVALID" for IP: 255.255.255.255
@@ -61,31 +85,106 @@ char * num_to_ipv4(ikey_t num) {
     bytes[3] = (num >> (BITSPERBYTE * 3)) & mask;   
     sprintf(result, "%d.%d.%d.%d", bytes[3], bytes[2], bytes[1], bytes[0]);
     // puts assigned byte values into their correct "dot" locations
-    
+
+}
+
+
+
+/// Converts IPV6 text to its numerical (ikey6_t) representation.
+
+int ipv6_to_num(char ip[BUFLEN], ikey6_t * num) {
+
+    char text[INET6_ADDRSTRLEN];
+    unsigned char bytes[16];
+    int used = 0;
+
+    if (sscanf(ip, "%45[0-9A-Fa-f:.]%n", text, &used) != 1 ||
+        inet_pton(AF_INET6, text, bytes) != 1)  // handles malformed address
+        return 0;
+
+    for (char * c = ip + used; *c != '\0'; c++)  // only whitespace may follow
+        if (!isspace((unsigned char) *c))
+            return 0;
+
+    ikey6_t result = {0, 0};
+
+    for (size_t i = 0; i < 8; i++) {  // packs bytes in big-endian order
+
+        result.hi = (result.hi << BITSPERBYTE) | bytes[i];
+        result.lo = (result.lo << BITSPERBYTE) | bytes[i + 8];
+
+    }
+
+    *num = result;
+
+    return 1;
+
+}
+
+
+
+/// Converts numerical (ikey6_t) IP representation to IPV6 text.
+
+char * num_to_ipv6(ikey6_t num) {
+
+    char * result = (char *) calloc(INET6_ADDRSTRLEN, sizeof(char));
+
+    if (result != NULL)
+        num_to_ipv6_r(num, result);
+
     return result;
 
 }
 
 
 
+/// Writes the IPV6 text of an IP into a caller-supplied buffer.
+
+void num_to_ipv6_r(ikey6_t num, char result[INET6_ADDRSTRLEN]) {
+
+    unsigned char bytes[16];
+
+    for (size_t i = 0; i < 8; i++) {  // unpacks bytes in big-endian order
+
+        bytes[i] = (num.hi >> (BITSPERBYTE * (7 - i))) & (RADIX - 1);
+        bytes[i + 8] = (num.lo >> (BITSPERBYTE * (7 - i))) & (RADIX - 1);
+
+    }
+
+    inet_ntop(AF_INET6, bytes, result, INET6_ADDRSTRLEN);
+
+}
+
+
+
+/// Checks for the ::ffff:0:0/96 IPV4-mapped block.
+
+int ipv6_is_mapped(ikey6_t num) {
+
+    return num.hi == 0 && (num.lo >> BITSPERWORD) == 0xffff;
+
+}
+
+
+
 /// Custom function passed to Trie ADT for printing IP entry values.
 
 void place_ip_show_value(Entry entry, FILE * stream) {
 
-    char * raw_text = (char *) entry->value;
-    char * ip = num_to_ipv4(entry->key);
-    char val_info[COUNTRYDAT][strlen(raw_text) + 1];
+    char ip[IPV4STR + 1];
+    char val_info[COUNTRYDAT][BUFLEN];
+    // fixed buffers keep the query path free of allocation
+
+    num_to_ipv4_r(entry->key, ip);
 
-    sscanf(raw_text, "\"%[^\"]\",\"%[^\"]\",\"%[^\"]\",\"%[^\"]\"", 
-        val_info[0], val_info[1], val_info[2], val_info[3]);
+    sscanf((char *) entry->value, VALFORMAT, val_info[0], val_info[1],
+        val_info[2], val_info[3]);
         // gets data from stored format
 
     fprintf(stream, "%u: (%s, %s: %s, %s, %s)\n", entry->key, ip, val_info[0],
         val_info[1], val_info[3], val_info[2]);
         // displays data with correct formatting
 
-    free(ip);
-
 }
 
 
@@ -100,6 +199,37 @@ void delete_entry(Entry entry) {
 
 
 
+/// Custom function passed to Trie6 ADT for printing IPV6 entry values.
+
+void place_ip_show_value6(Entry6 entry, FILE * stream) {
+
+    char ip[INET6_ADDRSTRLEN];
+    char val_info[COUNTRYDAT][BUFLEN];
+
+    num_to_ipv6_r(entry->key, ip);
+
+    sscanf((char *) entry->value, VALFORMAT, val_info[0], val_info[1],
+        val_info[2], val_info[3]);
+        // gets data from stored format
+
+    fprintf(stream, "%s: (%s: %s, %s, %s)\n", ip, val_info[0],
+        val_info[1], val_info[3], val_info[2]);
+        // displays data with correct formatting
+
+}
+
+
+
+/// Custom function passed to Trie6 ADT for freeing entry value data.
+
+void delete_entry6(Entry6 entry) {
+
+    free(entry->value);
+
+}
+
+
+
 /// Parses a single line of CSV test and inserts data into Trie instance.
 
 void read_to_trie(Trie trie, char * data_line) {
@@ -136,6 +266,279 @@ void read_to_trie(Trie trie, char * data_line) {
 
 
 
+/// Parses a CSV line and inserts only its bounds that lie in one /8.
+
+void read_to_block(Trie trie, unsigned int block, char * data_line) {
+
+    ikey_t bounds[2];
+
+    char * lower_str = strtok(data_line, ",");
+    sscanf(lower_str, "\"%u\"", &bounds[0]);
+
+    char * upper_str = strtok(NULL, ",");
+    sscanf(upper_str, "\"%u\"", &bounds[1]);
+
+    char * country_data = strtok(NULL, "\n");
+
+    for (size_t i = 0; i < 2; i++) {  // each bound owns its own value copy
+
+        if (bounds[i] >> (BITSPERWORD - BITSPERBYTE) != block)
+            continue;
+
+        char * storage_str = malloc(strlen(country_data) + 1);
+        strcpy(storage_str, country_data);
+
+        ibt_insert(trie, bounds[i], storage_str);
+
+    }
+
+}
+
+
+
+/// Rereads one noted CSV row to fill in a lazily built /8 block.
+
+void load_block_row(Trie trie, unsigned int block, long row, void * stream) {
+
+    FILE * fp = (FILE *) stream;
+    char * buf = NULL;
+    size_t blen = 0;
+
+    flockfile(fp);
+    // blocks may be built on several threads at once
+
+    if (fseek(fp, row, SEEK_SET) != 0 || getline(&buf, &blen, fp) <= 0) {
+
+        perror("read failed");
+        exit(EXIT_FAILURE);
+
+    }
+    // handles read error
+
+    funlockfile(fp);
+
+    read_to_block(trie, block, buf);
+    free(buf);
+
+}
+
+
+
+/// Notes every CSV row under the /8 blocks of its bounds.
+
+void index_csv(LazyTrie lazy, FILE * stream) {
+
+    char * buf = NULL;
+    size_t blen = 0;
+    long row = ftell(stream);
+
+    while (getline(&buf, &blen, stream) > 0) {
+
+        ikey_t lower_num;
+        ikey_t upper_num;
+
+        if (sscanf(buf, "\"%u\",\"%u\"", &lower_num, &upper_num) == 2 &&
+            (!lzy_note(lazy, lower_num, row) ||
+            !lzy_note(lazy, upper_num, row))) {  // handles allocation error
+
+            fprintf(stderr, "error: failed to allocate memory for index\n");
+            exit(EXIT_FAILURE);
+
+        }
+
+        row = ftell(stream);
+
+    }
+
+    if (ferror(stream)) {  // handles read error
+
+        perror("read failed");
+        exit(EXIT_FAILURE);
+
+    }
+
+    if (lzy_keys(lazy) == 0) {  // handles empty dataset error
+
+        fprintf(stderr, "error: empty dataset\n");
+        exit(EXIT_FAILURE);
+
+    }
+
+    free(buf);
+
+}
+
+
+
+/// Parses a CSV line and adds both bounds to a Staged batch.
+
+void read_to_staged(Staged staged, char * data_line) {
+
+    ikey_t lower_num;
+    ikey_t upper_num;
+
+    char * lower_str = strtok(data_line, ",");
+    sscanf(lower_str, "\"%u\"", &lower_num);
+
+    char * upper_str = strtok(NULL, ",");
+    sscanf(upper_str, "\"%u\"", &upper_num);
+
+    char * country_data = strtok(NULL, "\n");
+
+    char * storage_str1 = malloc(strlen(country_data) + 1);
+    char * storage_str2 = malloc(strlen(country_data) + 1);
+    // each bound owns its value, as in read_to_trie
+
+    strcpy(storage_str1, country_data);
+    strcpy(storage_str2, country_data);
+
+    if (!stg_add(staged, lower_num, storage_str1) ||
+        !stg_add(staged, upper_num, storage_str2)) {  // handles memory error
+
+        fprintf(stderr, "error: failed to allocate memory for entries\n");
+        exit(EXIT_FAILURE);
+
+    }
+
+}
+
+
+
+/// Reads a CSV file into a Staged batch and publishes it.
+
+int read_csv_staged(Staged staged, FILE * stream) {
+
+    char * buf = NULL;
+    size_t blen = 0;
+    char empty = 1;
+
+    while (getline(&buf, &blen, stream) > 0) {
+
+        read_to_staged(staged, buf);
+        empty = 0;
+
+    }
+
+    free(buf);
+
+    if (ferror(stream)) {  // handles read error
+
+        perror("read failed");
+        exit(EXIT_FAILURE);
+
+    }
+
+    if (empty) {  // handles empty dataset error
+
+        fprintf(stderr, "error: empty dataset\n");
+        return 0;
+
+    }
+
+    if (!stg_publish(staged))  // the sorted entries still serve
+        fprintf(stderr, "error: failed to start background trie build\n");
+
+    return 1;
+
+}
+
+
+
+/// Parses a quoted IPV6 CSV bound, given either in decimal or as IPV6 text.
+///
+/// @param field - the quoted CSV field
+/// @param bound - where the numerical IPV6 representation is stored
+///
+/// @return 1 on success, 0 if the bound is malformed IPV6 text
+
+static int parse_bound6(char * field, ikey6_t * bound) {
+
+    char text[BUFLEN] = "";
+    ikey6_t num = {0, 0};
+
+    sscanf(field, "\"%[^\"]\"", text);
+
+    if (strchr(text, ':') != NULL)  // bound is in IPV6 text notation
+        return ipv6_to_num(text, bound);
+
+    for (char * c = text; *c >= '0' && *c <= '9'; c++) {  // num = num * 10 + d
+
+        unsigned long long lo8 = num.lo << 3;
+        unsigned long long lo2 = num.lo << 1;
+        unsigned long long hi = (num.hi << 3) + (num.hi << 1) +
+            (num.lo >> 61) + (num.lo >> 63);
+        // num * 8 + num * 2, carrying the bits shifted out of the low half
+
+        num.lo = lo8 + lo2;
+        hi += (num.lo < lo8);
+        num.lo += (unsigned long long) (*c - '0');
+        hi += (num.lo < (unsigned long long) (*c - '0'));
+        num.hi = hi;
+
+    }
+
+    *bound = num;
+
+    return 1;
+
+}
+
+
+
+/// Parses a single line of IPV6 CSV text and inserts data into Trie6 instance.
+
+void read_to_trie6(Trie6 trie, char * data_line) {
+
+    ikey6_t lower_num;
+    ikey6_t upper_num;
+
+    if (!parse_bound6(strtok(data_line, ","), &lower_num) ||
+        !parse_bound6(strtok(NULL, ","), &upper_num)) {  // skips the row
+
+        fprintf(stderr, "error: invalid ipv6 address\n");
+        return;
+
+    }
+
+    char * country_data = strtok(NULL, "\n");
+
+    if (ipv6_is_mapped(lower_num) && ipv6_is_mapped(upper_num))
+        return;
+    // IPV4-mapped rows are answered from the IPV4 trie
+
+    char * storage_str1 = malloc(strlen(country_data) + 1);
+    char * storage_str2 = malloc(strlen(country_data) + 1);
+
+    strcpy(storage_str1, country_data);
+    strcpy(storage_str2, country_data);
+    // stores remaining data for lower and upper-bound IP addresses
+
+    ibt6_insert(trie, lower_num, storage_str1);
+    ibt6_insert(trie, upper_num, storage_str2);
+
+}
+
+
+
+/// Reads each line of the IPV6 CSV file, calling read_to_trie6 on each.
+
+void read_csv6(Trie6 trie, FILE * stream) {
+
+    char * buf = NULL;
+    size_t blen = 0;
+
+    while (getline(&buf, &blen, stream) > 0)
+        read_to_trie6(trie, buf);
+
+    if (ferror(stream))  // handles read error
+        perror("read failed");
+
+    free(buf);
+
+}
+
+
+
 /// Reads each line of the CSV file, calling read_to_trie to process data.
 
 void read_csv(Trie trie, FILE * stream) {
@@ -187,7 +590,45 @@ void display_stats(Trie trie) {
 
     printf("\nheight: %zu\n", ibt_height(trie));
     printf("size: %zu\n", ibt_size(trie));
-    printf("node_count: %zu\n\n\n", ibt_node_count(trie));
+    printf("node_count: %zu\n", ibt_node_count(trie));
+    printf("jump_direct: %zu\n", ibt_jump_direct(trie));
+
+    size_t huge;
+    size_t mapped = ibt_arena_mapped(trie, &huge);
+
+    printf("arena_mapped: %zu (%zu on huge pages)\n\n\n", mapped, huge);
+
+}
+
+
+
+/// Plans and displays multibit trie strides for the requested budgets.
+
+void display_strides(Trie trie, size_t max_levels,
+    unsigned long long max_bytes) {
+
+    Strides plan;
+
+    if (max_levels != 0 && vst_fit_depth(trie, max_levels, &plan)) {
+
+        printf("\nbest strides for %zu levels\n", max_levels);
+        vst_show(&plan, stdout);
+
+    }
+
+    if (max_bytes == 0)
+        return;
+
+    if (vst_fit_memory(trie, max_bytes, &plan)) {
+
+        printf("\nbest strides for %llu bytes\n", max_bytes);
+        vst_show(&plan, stdout);
+
+    }
+
+    else  // handles unreachable memory budget
+        fprintf(stderr, "error: no stride layout fits in %llu bytes\n",
+            max_bytes);
 
 }
 
@@ -217,12 +658,116 @@ ikey_t convert_query(char query[BUFLEN]) {
 
 
 
+/// Range scan callback that displays each entry found in a block.
+///
+/// @param entry - the entry inside the block
+/// @param stream - file stream to display entry
+
+static void show_block_entry(Entry entry, void * stream) {
+
+    place_ip_show_value(entry, (FILE *) stream);
+
+}
+
+
+
+/// Lists every range endpoint inside a CIDR block such as 55.3.0.0/16.
+
+void execute_block_query(Trie trie, char query[BUFLEN]) {
+
+    char * end;
+    long prefix = strtol(strchr(query, '/') + 1, &end, 10);
+
+    if (prefix < 0 || prefix > (long) BITSPERWORD || (*end != '\n' &&
+        *end != '\0')) {  // handles malformed prefix length
+
+        fprintf(stderr, "error: invalid CIDR prefix length\n");
+        return;
+
+    }
+
+    ikey_t host_mask = (prefix == 0) ? (ikey_t) -1 :
+        ((ikey_t) 1 << (BITSPERWORD - prefix)) - 1;
+    // bits of the address that vary within the block
+
+    ikey_t lo = ipv4_to_num(query) & ~host_mask;
+    ikey_t hi = lo | host_mask;
+
+    if (ibt_range(trie, lo, hi, show_block_entry, stdout) == 0)
+        printf("no ranges in block\n");
+
+}
+
+
+
+/// Searches whichever structure serves IPV4 queries.
+
+Entry search_ipv4(Trie trie, LazyTrie lazy, Staged staged, ikey_t key) {
+
+    if (lazy != NULL)  // builds the key's /8 on first touch
+        return lzy_search(lazy, key);
+
+    if (staged != NULL)  // sorted array until the trie is swapped in
+        return stg_search(staged, key);
+
+    return ibt_search(trie, key);
+
+}
+
+
+
 /// Processes and executes a user search query, then displays search results.
 
-void execute_query(Trie trie, char query[BUFLEN]) {
+void execute_query(Trie trie, LazyTrie lazy, Staged staged, Trie6 trie6,
+    Capture capture, char query[BUFLEN]) {
 
     ikey_t num_query;
 
+    if (strchr(query, ':') != NULL) {  // query is in IPV6 notation
+
+        ikey6_t num6;
+
+        if (!ipv6_to_num(query, &num6)) {  // nothing to search for
+
+            fprintf(stderr, "error: invalid ipv6 address\n");
+            return;
+
+        }
+
+        if (ipv6_is_mapped(num6)) {  // served from the IPV4 trie
+
+            if (capture != NULL)
+                cap_record(capture, (ikey_t) num6.lo);
+
+            place_ip_show_value(search_ipv4(trie, lazy, staged,
+                (ikey_t) num6.lo), stdout);
+            return;
+
+        }
+
+        if (trie6 == NULL || ibt6_size(trie6) == 0) {  // no IPV6 data
+
+            fprintf(stderr, "error: no ipv6 dataset loaded\n");
+            return;
+
+        }
+
+        ibt6_show_value(trie6, ibt6_search(trie6, num6), stdout);
+        return;
+
+    }
+
+    if (strchr(query, '/') != NULL) {  // query is a CIDR block
+
+        if (lazy != NULL || staged != NULL)  // range scans need the trie
+            fprintf(stderr, "error: block queries need a fully built trie\n");
+        else
+            execute_block_query(trie, query);
+
+        return;
+
+    }
+
     if (strchr(query, '.') == NULL) {  // query is in numeral notation
          
         num_query = convert_query(query);
@@ -233,7 +778,10 @@ void execute_query(Trie trie, char query[BUFLEN]) {
 
     }
 
-    Entry res = ibt_search(trie, num_query);
+    if (capture != NULL)  // logs the key exactly as it is searched
+        cap_record(capture, num_query);
+
+    Entry res = search_ipv4(trie, lazy, staged, num_query);
 
     if (res == NULL) {  // handles unexpected query search failure
 
@@ -244,7 +792,64 @@ void execute_query(Trie trie, char query[BUFLEN]) {
 
     }
 
-    ibt_show_value(trie, res, stdout);
+    place_ip_show_value(res, stdout);
+
+}
+
+
+
+/// Rereads the CSV file and serves it while its trie builds.
+
+void reload_staged(Staged staged, char * filename) {
+
+    FILE * fp = fopen(filename, "r");
+
+    if (fp == NULL) {  // keeps serving the current data
+
+        perror(filename);
+        return;
+
+    }
+
+    char loaded = read_csv_staged(staged, fp);
+    fclose(fp);
+
+    if (loaded)
+        printf("reloaded %s; trie building in background\n", filename);
+    else  // keeps serving the current data
+        fprintf(stderr, "error: %s not reloaded\n", filename);
+
+}
+
+
+
+/// Gives stdin and stdout static buffers before any I/O happens.
+
+void prepare_deterministic(void) {
+
+    static char in_buf[BUFSIZ];
+    static char out_buf[BUFSIZ];
+
+    setvbuf(stdin, in_buf, _IOLBF, BUFSIZ);
+    setvbuf(stdout, out_buf, _IOLBF, BUFSIZ);
+
+}
+
+
+
+/// Locks all memory and faults in the stack the query path will use.
+
+void lock_deterministic(void) {
+
+    volatile char stack[PREFAULT];
+
+    for (size_t i = 0; i < PREFAULT; i += 64)  // touches every stack page
+        stack[i] = 0;
+
+    (void) stack[0];
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)  // serving works unlocked
+        perror("mlockall");
 
 }
 
@@ -260,18 +865,128 @@ void execute_query(Trie trie, char query[BUFLEN]) {
 
 int main(int argc, char * argv[]) {
 
-    if (argc != 2) {  // handles incorrect command arguments error
+    char leaf_push = 0;
+    char jump = 0;
+    char * filename6 = NULL;
+    size_t max_levels = 0;
+    unsigned long long max_bytes = 0;
+    size_t profile = 0;
+    int arena = 0;
+    char deterministic = 0;
+    char lazy_load = 0;
+    char background = 0;
+    char * capture_name = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "ljd:m:p:HPLDzbc:6:")) != -1) {  // options
+
+        switch (opt) {
+
+            case 'l':  // leaf-push the trie once loaded
+                leaf_push = 1;
+                break;
+
+            case 'j':  // build the top-level jump table once loaded
+                jump = 1;
+                break;
+
+            case 'd':  // plan multibit strides for a depth budget
+                max_levels = (size_t) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'm':  // plan multibit strides for a memory budget
+                max_bytes = strtoull(optarg, NULL, 10);
+                break;
+
+            case 'p':  // sample every n-th search to lay out hot nodes
+                profile = (size_t) strtoul(optarg, NULL, 10);
+                break;
+
+            case 'H':  // node and entry storage on 2 MB pages
+                arena |= ARN_HUGETLB;
+                break;
+
+            case 'P':  // prefault node and entry storage
+                arena |= ARN_POPULATE;
+                break;
+
+            case 'L':  // lock node and entry storage in memory
+                arena |= ARN_LOCK;
+                break;
+
+            case 'D':  // serve with no allocation and no page faults
+                deterministic = 1;
+                break;
+
+            case 'z':  // build each /8 subtrie on first touch
+                lazy_load = 1;
+                break;
+
+            case 'b':  // serve a sorted array while the trie builds
+                background = 1;
+                break;
+
+            case 'c':  // record searched keys for replay
+                capture_name = optarg;
+                break;
+
+            case '6':  // IPV6 dataset to load alongside the IPV4 one
+                filename6 = optarg;
+                break;
+
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+
+        }
+
+    }
+
+    if (argc - optind != 1) {  // handles incorrect command arguments error
+
+        fprintf(stderr, USAGE);
+        return EXIT_FAILURE;
+
+    }
+
+    if (deterministic && profile != 0) {  // relayout allocates while serving
+
+        fprintf(stderr, "error: -p cannot be combined with -D\n");
+        return EXIT_FAILURE;
+
+    }
+
+    if (deterministic && (lazy_load || background)) {  // both build lazily
+
+        fprintf(stderr, "error: -z and -b cannot be combined with -D\n");
+        return EXIT_FAILURE;
 
-        fprintf(stderr, "usage: place_ip filename\n");
+    }
+
+    if ((lazy_load || background) && (max_levels != 0 || max_bytes != 0 ||
+        profile != 0 || arena != 0 || (lazy_load && (leaf_push || jump ||
+        background)))) {
+
+        fprintf(stderr, "error: -z and -b cannot be combined with trie "
+            "options (-b takes -l and -j)\n");
         return EXIT_FAILURE;
 
     }
+    // those options act on a trie built up front; the -b builder applies
+    // -l and -j itself before swapping its trie in
+
+    if (deterministic)  // -D implies -P and -L
+        arena |= ARN_POPULATE | ARN_LOCK;
 
-    FILE * fp = fopen(argv[1], "r");
+    if (deterministic)  // stdio buffers are set up now, not on first use
+        prepare_deterministic();
+
+    char * filename = argv[optind];
+    FILE * fp = fopen(filename, "r");
 
     if (fp == NULL) {  // handles file error
 
-        perror(argv[1]);
+        perror(filename);
         return EXIT_FAILURE;
 
     }
@@ -287,14 +1002,127 @@ int main(int argc, char * argv[]) {
 
     }
 
-    read_csv(trie, fp);
-    fclose(fp);
+    if (arena != 0 && !ibt_use_arena(trie, arena)) {  // handles arena error
+
+        fprintf(stderr, "error: failed to set up node arena\n");
+        ibt_destroy(trie);
+        fclose(fp);
+
+        return EXIT_FAILURE;
 
-    display_stats(trie);
+    }
 
-    puts("Enter an ipv4 string or a number (or a blank line to quit).");
+    LazyTrie lazy = NULL;
+    Staged staged = NULL;
+
+    if (background) {  // answers come from the sorted array right away
+
+        staged = stg_create(place_ip_show_value, delete_entry);
+
+        if (staged == NULL) {  // handles memory allocation error
+
+            fprintf(stderr, "error: failed to allocate memory for entries\n");
+            ibt_destroy(trie);
+            fclose(fp);
+
+            return EXIT_FAILURE;
+
+        }
+
+        stg_layout(staged, leaf_push, jump);
+
+        if (!read_csv_staged(staged, fp)) {  // exits as read_csv does
+
+            stg_destroy(staged);
+            ibt_destroy(trie);
+            fclose(fp);
+
+            return EXIT_FAILURE;
+
+        }
+
+        fclose(fp);
+
+        printf("\nserving sorted entries; trie building in background\n\n\n");
+
+    } else if (lazy_load) {  // indexes rows only; the file stays open
+
+        lazy = lzy_create(load_block_row, fp, place_ip_show_value,
+            delete_entry);
+
+        if (lazy == NULL) {  // handles index memory allocation error
+
+            fprintf(stderr, "error: failed to allocate memory for index\n");
+            ibt_destroy(trie);
+            fclose(fp);
+
+            return EXIT_FAILURE;
+
+        }
+
+        index_csv(lazy, fp);
+        printf("\nlazy keys: %zu\n\n\n", lzy_keys(lazy));
+
+    } else {
+
+        read_csv(trie, fp);
+        fclose(fp);
+
+        display_strides(trie, max_levels, max_bytes);
+
+        if (leaf_push)  // every lookup becomes a fixed root-to-leaf walk
+            ibt_leaf_push(trie);
+
+        if (jump && !ibt_jump_build(trie))  // searches still work without it
+            fprintf(stderr,
+                "error: failed to allocate memory for jump table\n");
+
+        display_stats(trie);
+
+    }
+
+    Trie6 trie6 = NULL;
+
+    if (filename6 != NULL) {  // loads the optional IPV6 dataset
+
+        FILE * fp6 = fopen(filename6, "r");
+
+        if (fp6 == NULL) {  // handles file error
+
+            perror(filename6);
+            ibt_destroy(trie);
+
+            return EXIT_FAILURE;
+
+        }
+
+        trie6 = ibt6_create(place_ip_show_value6, delete_entry6);
+        read_csv6(trie6, fp6);
+        fclose(fp6);
+
+        printf("ipv6 height: %zu\n", ibt6_height(trie6));
+        printf("ipv6 size: %zu\n", ibt6_size(trie6));
+        printf("ipv6 node_count: %zu\n\n\n", ibt6_node_count(trie6));
+
+    }
+
+    puts("Enter an ipv4 or ipv6 string or a number (or a blank line to quit).");
 
     char query[BUFLEN];
+    size_t queries = 0;
+
+    ibt_profile(trie, profile);
+
+    Capture capture = NULL;
+
+    if (capture_name != NULL &&
+        (capture = cap_create(capture_name)) == NULL)  // serving goes on
+        perror(capture_name);
+
+    if (deterministic)  // everything is loaded, so pin it all
+        lock_deterministic();
+
+    size_t allocs = alc_calls();
 
     while (1) {  // query loop
 
@@ -308,13 +1136,55 @@ int main(int argc, char * argv[]) {
 
         }
 
-        execute_query(trie, query);
+        if (staged != NULL && strcmp(query, "reload\n") == 0) {  // rereads
+
+            reload_staged(staged, filename);
+            continue;
+
+        }
+
+        execute_query(trie, lazy, staged, trie6, capture, query);
+
+        if (profile != 0 && ++queries % RELAYOUT == 0)  // follows hot paths
+            ibt_relayout(trie);
+
+    }
+
+    if (deterministic && alc_active())  // proves the loop never allocated
+        printf("query_allocations: %zu\n", alc_calls() - allocs);
+
+    if (capture != NULL) {  // flushes the capture and reports its size
+
+        size_t captured = cap_count(capture);
+
+        if (cap_close(capture))
+            printf("captured queries: %zu\n", captured);
+        else
+            fprintf(stderr, "error: failed to write %s\n", capture_name);
 
     }
     
 
+    if (staged != NULL) {  // waits for any build still running
+
+        printf("trie swapped in: %s\n", stg_trie(staged) ? "yes" : "no");
+        stg_destroy(staged);
+
+    }
+
+    if (lazy != NULL) {  // reports how little of the trie was built
+
+        printf("lazy blocks built: %zu\n", lzy_built(lazy));
+        lzy_destroy(lazy);
+        fclose(fp);
+
+    }
+
     ibt_destroy(trie);
 
+    if (trie6 != NULL)
+        ibt6_destroy(trie6);
+
     return EXIT_SUCCESS;
 
 }
\ No newline at end of file
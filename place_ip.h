@@ -17,13 +17,29 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <limits.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/mman.h>
 
 #include "trie.h"
+#include "trie6.h"
+#include "stride.h"
+#include "alloc_count.h"
+#include "lazy_trie.h"
+#include "staged.h"
+#include "capture.h"
 
 #define BUFLEN 512
 // maximum command query length
 
+#define IPV4STR 15
+// IPV4 string length maximum
+
+#define RELAYOUT 65536
+// queries between hot node relayouts when profiling
+
 
 
 /// Converts IPV4 address in "dot" notation into numerical IP representation.
@@ -46,6 +62,59 @@ char * num_to_ipv4(ikey_t num);
 
 
 
+/// Writes the IPV4 "dot" notation of a numerical IP into a buffer, with no
+/// allocation.
+///
+/// @param num - the numerical IP representation
+/// @param result - the buffer for the "dot" notation
+
+void num_to_ipv4_r(ikey_t num, char result[IPV4STR + 1]);
+
+
+
+/// Converts IPV6 address text (RFC 4291 notation) into numerical
+/// representation.
+///
+/// @param ip - the IPV6 text representation, optionally followed by
+///     whitespace
+/// @param num - where the numerical IPV6 representation is stored
+///
+/// @return 1 on success, 0 if the text is not a valid IPV6 address
+
+int ipv6_to_num(char ip[BUFLEN], ikey6_t * num);
+
+
+
+/// Converts numerical IPV6 representation to IPV6 text notation.
+///
+/// @param num - the numerical IP representation
+///
+/// @return the IPV6 address in compressed text notation
+
+char * num_to_ipv6(ikey6_t num);
+
+
+
+/// Writes the IPV6 text of a numerical IP into a buffer, with no allocation.
+///
+/// @param num - the numerical IP representation
+/// @param result - the buffer for the text notation
+
+void num_to_ipv6_r(ikey6_t num, char result[INET6_ADDRSTRLEN]);
+
+
+
+/// Checks whether an IPV6 address is an IPV4-mapped address (::ffff:a.b.c.d).
+/// Such addresses are served by the IPV4 trie.
+///
+/// @param num - the numerical IPV6 representation
+///
+/// @return 1 if the address is IPV4-mapped, else 0
+
+int ipv6_is_mapped(ikey6_t num);
+
+
+
 /// Function to display trie entries of specified (char *) type.
 ///
 /// @param entry - the trie node entry to display
@@ -65,6 +134,23 @@ void delete_entry(Entry entry);
 
 
 
+/// Function to display IPV6 trie entries of specified (char *) type.
+///
+/// @param entry - the trie node entry to display
+/// @param stream - file stream to display entry
+
+void place_ip_show_value6(Entry6 entry, FILE * stream);
+
+
+
+/// Function to free place_ip-specific IPV6 trie entry data values.
+///
+/// @param entry - the entry to free data in
+
+void delete_entry6(Entry6 entry);
+
+
+
 /// Parses a single CSV file line and inserts data as a Trie node.
 ///
 /// @param trie - the Trie instance
@@ -83,6 +169,79 @@ void read_csv(Trie trie, FILE * stream);
 
 
 
+/// Parses a single CSV file line and inserts only its bounds inside one /8
+/// block as Trie nodes.
+///
+/// @param trie - the block's Trie instance
+/// @param block - the /8 block (top key byte)
+/// @param data_line - the CSV file line
+
+void read_to_block(Trie trie, unsigned int block, char * data_line);
+
+
+
+/// LazyTrie loader: rereads the CSV row at an offset into a block's Trie.
+///
+/// @param trie - the block's Trie instance
+/// @param block - the /8 block (top key byte)
+/// @param row - the row's file offset
+/// @param stream - the CSV file stream (as void *)
+
+void load_block_row(Trie trie, unsigned int block, long row, void * stream);
+
+
+
+/// Notes the file offset of every CSV row in a LazyTrie, under the /8
+/// blocks of its bounds, without building any Trie.
+///
+/// @param lazy - the LazyTrie instance
+/// @param stream - file stream where data is being read from
+
+void index_csv(LazyTrie lazy, FILE * stream);
+
+
+
+/// Parses a single CSV file line and adds both bounds to a Staged batch.
+///
+/// @param staged - the Staged instance
+/// @param data_line - the CSV file line
+
+void read_to_staged(Staged staged, char * data_line);
+
+
+
+/// Reads data from CSV file into a Staged batch and publishes it: the
+/// sorted entries serve at once while the trie builds in the background.
+///
+/// @param staged - the Staged instance
+/// @param stream - file stream where data is being read from
+///
+/// @return 1 if rows were read, 0 on an empty dataset (nothing published)
+
+int read_csv_staged(Staged staged, FILE * stream);
+
+
+
+/// Parses a single IPV6 CSV file line and inserts data as Trie6 nodes.
+/// Bounds may be decimal 128-bit numbers or IPV6 text; rows inside the
+/// IPV4-mapped block are skipped since the IPV4 trie serves them.
+///
+/// @param trie - the Trie6 instance
+/// @param data_line - the CSV file line
+
+void read_to_trie6(Trie6 trie, char * data_line);
+
+
+
+/// Reads data from IPV6 CSV file to Trie6 instance.
+///
+/// @param trie - the Trie6 instance
+/// @param stream - file stream where data is being read from
+
+void read_csv6(Trie6 trie, FILE * stream);
+
+
+
 /// Displays trie structure statistics.
 ///
 /// @param trie - the Trie instance
@@ -91,6 +250,43 @@ void display_stats(Trie trie);
 
 
 
+/// Plans multibit trie strides for a depth budget and for a memory
+/// budget (either skipped when 0) and displays the chosen layouts.
+///
+/// @param trie - the Trie instance
+/// @param max_levels - the most table reads a lookup may take
+/// @param max_bytes - the most table memory allowed
+
+void display_strides(Trie trie, size_t max_levels,
+    unsigned long long max_bytes);
+
+
+
+/// Rereads the CSV file into a Staged instance; the new data serves from
+/// its sorted array at once and from its trie once built. An empty file
+/// leaves the current data serving.
+///
+/// @param staged - the Staged instance
+/// @param filename - the CSV file name
+
+void reload_staged(Staged staged, char * filename);
+
+
+
+/// Sets up deterministic serving before any I/O: stdin and stdout get
+/// static buffers, so stdio never allocates on the query path.
+
+void prepare_deterministic(void);
+
+
+
+/// Finishes deterministic serving setup once loading is done: the stack
+/// the query path uses is faulted in and all memory is locked.
+
+void lock_deterministic(void);
+
+
+
 /// Converts string user command query to ikey_t (unsigned int) type.
 ///
 /// @param query - the user search query
@@ -101,12 +297,40 @@ ikey_t convert_query(char query[BUFLEN]);
 
 
 
+/// Lists every range endpoint inside a CIDR block query ("55.3.0.0/16").
+///
+/// @param trie - the Trie instance
+/// @param query - the user block query
+
+void execute_block_query(Trie trie, char query[BUFLEN]);
+
+
+
+/// Searches whichever structure serves IPV4 queries.
+///
+/// @param trie - the Trie instance
+/// @param lazy - the LazyTrie serving instead of trie (NULL if none)
+/// @param staged - the Staged instance serving instead of trie (NULL if none)
+/// @param key - the key to find
+///
+/// @return the closest matching entry
+
+Entry search_ipv4(Trie trie, LazyTrie lazy, Staged staged, ikey_t key);
+
+
+
 /// Handles user search query, passes to Trie instance, and displays result.
+/// IPV6 queries go to the Trie6 instance unless they are IPV4-mapped.
 ///
 /// @param trie - the Trie instance
+/// @param lazy - the LazyTrie serving IPV4 instead of trie (NULL if none)
+/// @param staged - the Staged instance serving IPV4 instead (NULL if none)
+/// @param trie6 - the Trie6 instance (NULL when no IPV6 data is loaded)
+/// @param capture - records each IPV4 key searched (NULL if not capturing)
 /// @param query - the user search query
 
-void execute_query(Trie trie, char query[BUFLEN]);
+void execute_query(Trie trie, LazyTrie lazy, Staged staged, Trie6 trie6,
+    Capture capture, char query[BUFLEN]);
 
 
 
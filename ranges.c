@@ -0,0 +1,203 @@
+// File: ranges.c
+//
+// Description: module for a normalized, sorted table of IP ranges, the
+// common input of the read-only lookup engines
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "ranges.h"
+
+
+
+/// Defines the struct for the Ranges ADT
+struct Ranges_s {
+
+    struct Range_s * items;
+    size_t count;
+    size_t cap;
+    // range array
+
+    void (*rng_delete_value)(ival_t value);
+    // pointer to user-passed value deletion function
+
+};
+
+
+
+/// Creates and returns an empty Ranges instance.
+
+Ranges rng_create(void (*ext_delete_value)(ival_t value)) {
+
+    Ranges ranges = (Ranges) malloc(sizeof(struct Ranges_s));
+
+    if (ranges == NULL)  // signifies an allocation failure
+        return NULL;
+
+    ranges->items = NULL;
+    ranges->count = 0;
+    ranges->cap = 0;
+    ranges->rng_delete_value = ext_delete_value;
+
+    return ranges;
+
+}
+
+
+
+/// Frees the table and every value in it.
+
+void rng_destroy(Ranges ranges) {
+
+    if (ranges->rng_delete_value != NULL)  // calls user value free function
+        for (size_t i = 0; i < ranges->count; i++)
+            ranges->rng_delete_value(ranges->items[i].value);
+
+    free(ranges->items);
+    free(ranges);
+
+}
+
+
+
+/// Appends a range, doubling the array when full.
+
+int rng_add(Ranges ranges, ikey_t lo, ikey_t hi, ival_t value) {
+
+    if (ranges->count == ranges->cap) {  // grows range array
+
+        size_t cap = (ranges->cap == 0) ? 64 : ranges->cap * 2;
+        struct Range_s * items = (struct Range_s *) realloc(ranges->items,
+            cap * sizeof(struct Range_s));
+
+        if (items == NULL)  // handles memory error, table unchanged
+            return 0;
+
+        ranges->items = items;
+        ranges->cap = cap;
+
+    }
+
+    struct Range_s * r = &ranges->items[ranges->count++];
+
+    r->lo = (lo <= hi) ? lo : hi;
+    r->hi = (lo <= hi) ? hi : lo;
+    r->value = value;
+
+    return 1;
+
+}
+
+
+
+/// Orders ranges by lower bound, then by upper bound.
+///
+/// @param a - the first range
+/// @param b - the second range
+///
+/// @return negative, zero or positive as for qsort
+
+static int rng_compare(const void * a, const void * b) {
+
+    const struct Range_s * ra = (const struct Range_s *) a;
+    const struct Range_s * rb = (const struct Range_s *) b;
+
+    if (ra->lo != rb->lo)
+        return (ra->lo < rb->lo) ? -1 : 1;
+
+    if (ra->hi != rb->hi)
+        return (ra->hi > rb->hi) ? -1 : 1;
+
+    return 0;
+
+}
+
+
+
+/// Sorts and clips the table into disjoint ranges.
+
+void rng_normalize(Ranges ranges) {
+
+    qsort(ranges->items, ranges->count, sizeof(struct Range_s), rng_compare);
+
+    size_t kept = 0;
+
+    for (size_t i = 0; i < ranges->count; i++) {  // clips against the last kept
+
+        struct Range_s r = ranges->items[i];
+
+        if (kept > 0) {
+
+            ikey_t last_hi = ranges->items[kept - 1].hi;
+
+            if (r.hi <= last_hi) {  // wholly covered, so dropped
+
+                if (ranges->rng_delete_value != NULL)
+                    ranges->rng_delete_value(r.value);
+
+                continue;
+
+            }
+
+            if (r.lo <= last_hi)  // overlap goes to the earlier range
+                r.lo = last_hi + 1;
+
+        }
+
+        ranges->items[kept++] = r;
+
+    }
+
+    ranges->count = kept;
+
+}
+
+
+
+/// Fetches the range count.
+
+size_t rng_count(Ranges ranges) {
+
+    return ranges->count;
+
+}
+
+
+
+/// Fetches the range array.
+
+struct Range_s * rng_items(Ranges ranges) {
+
+    return ranges->items;
+
+}
+
+
+
+/// Binary searches for the last range starting at or before key.
+
+size_t rng_find(Ranges ranges, ikey_t key) {
+
+    size_t lo = 0;
+    size_t hi = ranges->count;
+
+    while (lo < hi) {  // finds the first range starting after key
+
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (ranges->items[mid].lo <= key)
+            lo = mid + 1;
+        else
+            hi = mid;
+
+    }
+
+    if (lo == 0 || ranges->items[lo - 1].hi < key)  // key is in a gap
+        return RNG_NONE;
+
+    return lo - 1;
+
+}
@@ -0,0 +1,115 @@
+// File: ranges.h
+//
+// Description: header for a normalized, sorted table of IP ranges
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef RANGES_H
+#define RANGES_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+
+#define RNG_NONE ((size_t) -1)
+// range index returned for keys that fall in no range
+
+
+
+/// Defines a single inclusive key range and its value.
+struct Range_s {
+
+    ikey_t lo;
+    ikey_t hi;
+    ival_t value;
+
+};
+
+
+
+/// Ranges is a pointer to the Ranges ADT.
+typedef struct Ranges_s * Ranges;
+
+
+
+/// Create an empty Ranges table.
+///
+/// @param ext_delete_value - a function pointer that the user passes
+///     to indicate how range values are freed (NULL if they are not)
+///
+/// @return pointer to the Ranges instance or NULL on failure
+
+Ranges rng_create(void (*ext_delete_value)(ival_t value));
+
+
+
+/// Destroy the table, freeing every value with the delete function.
+///
+/// @param ranges - a pointer to a Ranges instance
+
+void rng_destroy(Ranges ranges);
+
+
+
+/// Append a range to the table (lo and hi are swapped if reversed).
+///
+/// @param ranges - a pointer to a Ranges instance
+/// @param lo - the first key of the range
+/// @param hi - the last key of the range
+/// @param value - the value of the range
+///
+/// @return 1 on success, 0 if memory ran out (the table is unchanged)
+
+int rng_add(Ranges ranges, ikey_t lo, ikey_t hi, ival_t value);
+
+
+
+/// Sort the table by lower bound and make the ranges disjoint.
+/// Where ranges overlap, the one starting first keeps the overlap; ranges
+/// left empty are removed and their values freed.
+///
+/// @param ranges - a pointer to a Ranges instance
+///
+/// @post ranges are sorted, disjoint, and indexed 0 .. rng_count() - 1
+
+void rng_normalize(Ranges ranges);
+
+
+
+/// Get the number of ranges in the table.
+///
+/// @param ranges - a pointer to a Ranges instance
+///
+/// @return the range count
+
+size_t rng_count(Ranges ranges);
+
+
+
+/// Get the range array, in key order once normalized.
+///
+/// @param ranges - a pointer to a Ranges instance
+///
+/// @return the array of rng_count() ranges
+
+struct Range_s * rng_items(Ranges ranges);
+
+
+
+/// Find the range containing key by binary search (table normalized).
+///
+/// @param ranges - a pointer to a normalized Ranges instance
+/// @param key - the key to find
+///
+/// @return the index of the containing range or RNG_NONE
+
+size_t rng_find(Ranges ranges, ikey_t key);
+
+
+
+#endif  // RANGES_H
@@ -0,0 +1,310 @@
+// File: replay.c
+//
+// Description: feeds the keys of a place_ip query capture through any
+// lookup engine, at full speed or at the recorded pacing, and writes the
+// results as JSON
+//
+// @author: Max Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "replay.h"
+
+
+#define ROWS 1000000
+// synthetic rows when no file is given
+
+
+#define USAGE "usage: replay [-e engine|all] [-p] [-x speed] [-n rows] " \
+    "[-s seed] [-o json_file] [-l] [-j] capture_file [filename]\n"
+// command usage message
+
+
+
+static volatile size_t replay_sink;
+// receives checksums so the compiler keeps every lookup
+
+
+
+/// Finds an engine by name.
+
+int engine_index(const char * name) {
+
+    for (int e = 0; e < BENCH_ENGINES; e++)
+        if (strcmp(name, BENCH_ENGINE_NAMES[e]) == 0)
+            return e;
+
+    return -1;
+
+}
+
+
+
+/// Sleeps, then spins, until a deadline.
+
+void wait_until(unsigned long long deadline) {
+
+    unsigned long long now = wkl_now_ns();
+
+    if (now + SPINNS < deadline) {  // sleeps through most of a long gap
+
+        unsigned long long ns = deadline - now - SPINNS;
+        struct timespec ts;
+
+        ts.tv_sec = (time_t) (ns / 1000000000ULL);
+        ts.tv_nsec = (long) (ns % 1000000000ULL);
+        nanosleep(&ts, NULL);
+
+    }
+
+    while (wkl_now_ns() < deadline)  // spins through the rest
+        ;
+
+}
+
+
+
+/// Replays a capture at its recorded pacing.
+
+unsigned long long replay_paced(Bench * bench, int engine, ikey_t * keys,
+    unsigned long long * at_ns, size_t count, double speed, Hdr hist) {
+
+    unsigned long long lag = 0;
+    unsigned long long origin = wkl_now_ns();
+
+    for (size_t i = 0; i < count; i++) {
+
+        unsigned long long due = origin +
+            (unsigned long long) ((double) at_ns[i] / speed);
+
+        wait_until(due);
+
+        unsigned long long start = wkl_now_ns();
+        replay_sink += bench_search(bench, engine, &keys[i], 1);
+        hdr_record(hist, wkl_now_ns() - start);
+
+        if (start - due > lag)  // a slow lookup delays the ones behind it
+            lag = start - due;
+
+    }
+
+    return lag;
+
+}
+
+
+
+/// Program entry point.
+/// Loads a capture and a dataset, builds the engines and replays the
+/// capture through each one chosen.
+///
+/// @param argc - number of command line arguments
+/// @param argv - command line arguments
+///
+/// @return EXIT_SUCCESS or EXIT_FAILURE if error occurs
+
+int main(int argc, char * argv[]) {
+
+    char * engine_name = "trie";
+    char paced = 0;
+    double speed = 1;
+    size_t rows = 0;
+    unsigned long long seed = 1;
+    char * json_name = NULL;
+    char leaf_push = 0;
+    char jump = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "e:px:n:s:o:lj")) != -1) {
+
+        switch (opt) {
+
+            case 'e':  // engine to replay through, or all of them
+                engine_name = optarg;
+                break;
+
+            case 'p':  // keep the recorded gaps between queries
+                paced = 1;
+                break;
+
+            case 'x':  // speed up (or slow down) the recorded pacing
+                speed = strtod(optarg, NULL);
+                break;
+
+            case 'n':  // rows to generate, or the most to read from file
+                rows = (size_t) strtoull(optarg, NULL, 10);
+                break;
+
+            case 's':  // seed for synthetic rows
+                seed = strtoull(optarg, NULL, 10);
+                break;
+
+            case 'o':  // write JSON here instead of standard output
+                json_name = optarg;
+                break;
+
+            case 'l':  // leaf-push the trie once loaded
+                leaf_push = 1;
+                break;
+
+            case 'j':  // build the top-level jump table once loaded
+                jump = 1;
+                break;
+
+            default:
+                fprintf(stderr, USAGE);
+                return EXIT_FAILURE;
+
+        }
+
+    }
+
+    int all = strcmp(engine_name, "all") == 0;
+    int chosen = all ? BENCH_TRIE : engine_index(engine_name);
+
+    if (argc - optind < 1 || argc - optind > 2 || chosen < 0 ||
+        !(speed > 0)) {  // handles incorrect command arguments error
+
+        fprintf(stderr, USAGE);
+        return EXIT_FAILURE;
+
+    }
+
+    char * capture_name = argv[optind];
+    ikey_t * keys;
+    unsigned long long * at_ns;
+    size_t count;
+
+    if (!cap_load(capture_name, &keys, &at_ns, &count)) {  // capture error
+
+        fprintf(stderr, "error: %s is not a readable capture\n",
+            capture_name);
+        return EXIT_FAILURE;
+
+    }
+
+    char * filename = (optind + 1 < argc) ? argv[optind + 1] : NULL;
+    Workload work;
+
+    if (filename != NULL) {  // rows come from a place_ip CSV file
+
+        FILE * fp = fopen(filename, "r");
+
+        if (fp == NULL) {  // handles file error
+
+            perror(filename);
+            return EXIT_FAILURE;
+
+        }
+
+        work = wkl_read_csv(fp, rows);
+        fclose(fp);
+
+    } else {
+
+        work = wkl_synthetic((rows == 0) ? ROWS : rows, seed);
+
+    }
+
+    if (work == NULL || wkl_rows(work) == 0) {  // handles empty workload
+
+        fprintf(stderr, "error: no rows to load\n");
+        return EXIT_FAILURE;
+
+    }
+
+    Bench bench;
+    memset(&bench, 0, sizeof(Bench));
+    rid_init(&bench.rid);
+    bench.counters = pfc_open();
+
+    if (bench.counters == NULL || !bench_load_trie(&bench, work, 0) ||
+        ((all || chosen != BENCH_TRIE) &&
+        !bench_build_engines(&bench, work))) {  // handles engine errors
+
+        fprintf(stderr, "error: failed to allocate memory for engines\n");
+        return EXIT_FAILURE;
+
+    }
+
+    if (leaf_push)  // every lookup becomes a fixed root-to-leaf walk
+        ibt_leaf_push(bench.trie);
+
+    if (jump && !ibt_jump_build(bench.trie))  // searches still work without it
+        fprintf(stderr, "error: failed to allocate memory for jump table\n");
+
+    FILE * out = stdout;
+
+    if (json_name != NULL && (out = fopen(json_name, "w")) == NULL) {
+
+        perror(json_name);
+        return EXIT_FAILURE;
+
+    }
+
+    fprintf(out, "{\n  \"config\": {\"capture\": \"%s\", \"queries\": %zu, "
+        "\"recorded_ns\": %llu, \"source\": \"%s\", \"rows\": %zu,\n"
+        "    \"paced\": %d, \"speed\": %.3f, \"leaf_push\": %d, "
+        "\"jump\": %d},\n", capture_name, count,
+        (count == 0) ? 0 : at_ns[count - 1], (filename != NULL) ? filename :
+        "synthetic", wkl_rows(work), paced, speed, leaf_push, jump);
+
+    fprintf(out, "  \"replay\": {\n");
+
+    for (int e = chosen; e < (all ? BENCH_ENGINES : chosen + 1); e++) {
+
+        fprintf(out, "    \"%s\": ", BENCH_ENGINE_NAMES[e]);
+
+        if (paced) {  // latency of each lookup at production arrival times
+
+            Hdr hist = hdr_create();
+
+            if (hist == NULL) {  // handles memory allocation error
+
+                fprintf(stderr, "error: failed to allocate histogram\n");
+                return EXIT_FAILURE;
+
+            }
+
+            unsigned long long lag = replay_paced(&bench, e, keys, at_ns,
+                count, speed, hist);
+
+            fprintf(out, "{\"lookups\": %llu, \"mean_ns\": %.1f, "
+                "\"p50_ns\": %llu, \"p99_ns\": %llu, \"p99.9_ns\": %llu,\n"
+                "      \"max_ns\": %llu, \"max_lag_ns\": %llu}",
+                hdr_count(hist), hdr_mean(hist), hdr_percentile(hist, 50),
+                hdr_percentile(hist, 99), hdr_percentile(hist, 99.9),
+                hdr_max(hist), lag);
+
+            hdr_destroy(hist);
+
+        } else {  // back to back, with hardware counters
+
+            double ns = bench_time_search(&bench, e, keys, count);
+
+            fprintf(out, "{\"ns_per_op\": %.2f, \"per_lookup\": ", ns);
+            pfc_show(bench.counters, (double) count, out);
+            fprintf(out, "}");
+
+        }
+
+        fprintf(out, "%s\n", (all && e + 1 < BENCH_ENGINES) ? "," : "");
+
+    }
+
+    fprintf(out, "  }\n}\n");
+
+    if (out != stdout)
+        fclose(out);
+
+    pfc_close(bench.counters);
+    bench_destroy(&bench);
+    wkl_destroy(work);
+    free(keys);
+    free(at_ns);
+
+    return EXIT_SUCCESS;
+
+}
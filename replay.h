@@ -0,0 +1,68 @@
+// File: replay.h
+//
+// Description: function declarations and constants for the replay module
+//
+// @author: Max Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef REPLAY
+#define REPLAY
+
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "engines.h"
+#include "capture.h"
+#include "hdr.h"
+
+#define SPINNS 200000ULL
+// waits shorter than this spin instead of sleeping
+
+
+
+/// Finds an engine by name.
+///
+/// @param name - the engine name
+///
+/// @return the engine index, or -1 if there is none by that name
+
+int engine_index(const char * name);
+
+
+
+/// Waits until the monotonic clock reaches a deadline, sleeping through
+/// long waits and spinning through the last SPINNS nanoseconds.
+///
+/// @param deadline - the clock reading to wait for, in nanoseconds
+
+void wait_until(unsigned long long deadline);
+
+
+
+/// Replays a capture through an engine at its recorded pacing, timing
+/// each lookup.
+///
+/// @param bench - the engine set (passed as pointer)
+/// @param engine - the engine index
+/// @param keys - the captured keys
+/// @param at_ns - the captured arrival times
+/// @param count - the number of keys
+/// @param speed - the factor by which the recorded pacing is sped up
+/// @param hist - the histogram receiving nanoseconds per lookup
+///
+/// @return the most any lookup started behind its schedule, in nanoseconds
+
+unsigned long long replay_paced(Bench * bench, int engine, ikey_t * keys,
+    unsigned long long * at_ns, size_t count, double speed, Hdr hist);
+
+
+
+#endif  // REPLAY
@@ -0,0 +1,384 @@
+// File: staged.c
+//
+// Description: module for a sorted-array stand-in that serves searches
+// while the full trie builds in the background
+//
+// Sorting the entries takes a fraction of the time the trie needs, and a
+// binary search over sorted keys reproduces ibt_search exactly: the
+// trie's closest match is the predecessor or successor sharing the longer
+// prefix with the key. The builder thread publishes the finished Trie
+// through one pointer stored with release ordering; the searching thread
+// loads it with acquire ordering and, on first seeing it, joins the
+// builder and frees the array, so the array is never freed under a
+// reader.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "staged.h"
+
+
+
+/// Item_s is a batch entry with its position in the batch, so sorting
+/// keeps the first value added for a key.
+struct Item_s {
+
+    struct Entry_s entry;
+    size_t order;
+
+};
+
+
+
+/// Defines the struct for the Staged ADT
+struct Staged_s {
+
+    struct Item_s * items;
+    size_t count;
+    size_t cap;
+    // serving array once published, else the batch being added
+
+    struct Item_s * batch;
+    size_t batch_count;
+    size_t batch_cap;
+    // next batch while an array is serving
+
+    Trie built;
+    // the published Trie (NULL while the array serves)
+
+    pthread_t builder;
+    char building;
+    // background build thread, if one has not been joined
+
+    char leaf_push;
+    char jump;
+    // layout applied to each Trie before it is published (see stg_layout)
+
+    void (*ibt_show_value_w)(Entry entry, FILE * stream);
+    void (*ibt_delete_entry)(Entry entry);
+    // user-passed Trie functions
+
+};
+
+
+
+/// Creates and returns an empty Staged instance.
+
+Staged stg_create(void (*ext_show_value)(Entry entry, FILE * stream),
+    void (*ext_delete_entry)(Entry entry)) {
+
+    Staged staged = (Staged) calloc(1, sizeof(struct Staged_s));
+
+    if (staged == NULL)  // signifies an allocation failure
+        return NULL;
+
+    staged->ibt_show_value_w = ext_show_value;
+    staged->ibt_delete_entry = ext_delete_entry;
+
+    return staged;
+
+}
+
+
+
+/// Sets the layout of later builds.
+
+void stg_layout(Staged staged, char leaf_push, char jump) {
+
+    staged->leaf_push = leaf_push;
+    staged->jump = jump;
+
+}
+
+
+
+/// Loads the published Trie.
+///
+/// @param staged - the Staged instance
+///
+/// @return the Trie, or NULL if none is published
+
+static Trie stg_load_built(Staged staged) {
+
+#ifdef __GNUC__
+
+    return __atomic_load_n(&staged->built, __ATOMIC_ACQUIRE);
+
+#else
+
+    return staged->built;
+
+#endif
+
+}
+
+
+
+/// Frees the values of entries that no Trie took over.
+///
+/// @param staged - the Staged instance
+/// @param items - the entries
+/// @param count - the number of entries
+
+static void stg_free_values(Staged staged, struct Item_s * items,
+    size_t count) {
+
+    if (staged->ibt_delete_entry != NULL)
+        for (size_t i = 0; i < count; i++)
+            staged->ibt_delete_entry(&items[i].entry);
+
+}
+
+
+
+/// Waits for the builder and retires whatever the published data was.
+///
+/// @param staged - the Staged instance
+
+static void stg_retire(Staged staged) {
+
+    if (staged->building) {  // the builder owns the items until it exits
+
+        pthread_join(staged->builder, NULL);
+        staged->building = 0;
+
+    }
+
+    Trie built = stg_load_built(staged);
+
+    if (built != NULL)  // the Trie owns the values
+        ibt_destroy(built);
+    else
+        stg_free_values(staged, staged->items, staged->count);
+
+    free(staged->items);
+    staged->items = NULL;
+    staged->count = 0;
+    staged->cap = 0;
+    staged->built = NULL;
+
+}
+
+
+
+/// Frees everything, waiting for any build.
+
+void stg_destroy(Staged staged) {
+
+    stg_retire(staged);
+
+    stg_free_values(staged, staged->batch, staged->batch_count);
+    free(staged->batch);
+    free(staged);
+
+}
+
+
+
+/// Appends an entry to the next batch.
+
+int stg_add(Staged staged, ikey_t key, ival_t value) {
+
+    if (staged->batch_count == staged->batch_cap) {  // grows the batch
+
+        size_t cap = (staged->batch_cap == 0) ? 1024 : staged->batch_cap * 2;
+        struct Item_s * batch = (struct Item_s *) realloc(staged->batch,
+            cap * sizeof(struct Item_s));
+
+        if (batch == NULL)  // signifies an allocation failure
+            return 0;
+
+        staged->batch = batch;
+        staged->batch_cap = cap;
+
+    }
+
+    struct Item_s * item = &staged->batch[staged->batch_count];
+    item->entry.key = key;
+    item->entry.value = value;
+    item->order = staged->batch_count++;
+
+    return 1;
+
+}
+
+
+
+/// Orders items by key, then by the order they were added in.
+///
+/// @param a - the first item
+/// @param b - the second item
+///
+/// @return negative, zero or positive as a sorts before, with or after b
+
+static int stg_compare(const void * a, const void * b) {
+
+    const struct Item_s * x = (const struct Item_s *) a;
+    const struct Item_s * y = (const struct Item_s *) b;
+
+    if (x->entry.key != y->entry.key)
+        return (x->entry.key < y->entry.key) ? -1 : 1;
+
+    return (x->order < y->order) ? -1 : (x->order > y->order);
+
+}
+
+
+
+/// Builds the Trie from the sorted items, lays it out and publishes it.
+///
+/// @param arg - the Staged instance
+///
+/// @return NULL
+
+static void * stg_build(void * arg) {
+
+    Staged staged = (Staged) arg;
+    Trie trie = ibt_create(staged->ibt_show_value_w, staged->ibt_delete_entry);
+
+    if (trie == NULL)  // the array keeps serving
+        return NULL;
+
+    for (size_t i = 0; i < staged->count; i++)
+        ibt_insert(trie, staged->items[i].entry.key,
+            staged->items[i].entry.value);
+
+    if (staged->leaf_push)  // every lookup becomes a fixed root-to-leaf walk
+        ibt_leaf_push(trie);
+
+    if (staged->jump && !ibt_jump_build(trie))  // searches work without it
+        fprintf(stderr, "error: failed to allocate memory for jump table\n");
+
+#ifdef __GNUC__
+
+    __atomic_store_n(&staged->built, trie, __ATOMIC_RELEASE);
+
+#else
+
+    staged->built = trie;
+
+#endif
+
+    return NULL;
+
+}
+
+
+
+/// Sorts the batch, serves it and starts the background build.
+
+int stg_publish(Staged staged) {
+
+    if (staged->batch_count == 0)  // nothing to serve
+        return 0;
+
+    stg_retire(staged);
+
+    qsort(staged->batch, staged->batch_count, sizeof(struct Item_s),
+        stg_compare);
+
+    size_t count = 0;
+
+    for (size_t i = 0; i < staged->batch_count; i++) {  // drops duplicates
+
+        if (count > 0 &&
+            staged->batch[count - 1].entry.key == staged->batch[i].entry.key)
+            stg_free_values(staged, &staged->batch[i], 1);
+        else
+            staged->batch[count++] = staged->batch[i];
+
+    }
+
+    staged->items = staged->batch;
+    staged->count = count;
+    staged->cap = staged->batch_cap;
+
+    staged->batch = NULL;
+    staged->batch_count = 0;
+    staged->batch_cap = 0;
+
+    if (pthread_create(&staged->builder, NULL, stg_build, staged) != 0)
+        return 0;
+    // the sorted array keeps serving
+
+    staged->building = 1;
+
+    return 1;
+
+}
+
+
+
+/// Searches the Trie if it is ready, else the sorted array.
+
+Entry stg_search(Staged staged, ikey_t key) {
+
+    Trie built = stg_load_built(staged);
+
+    if (built != NULL) {
+
+        if (staged->items != NULL) {  // first search since the swap
+
+            pthread_join(staged->builder, NULL);
+            staged->building = 0;
+
+            free(staged->items);
+            staged->items = NULL;
+            staged->count = 0;
+
+        }
+
+        return ibt_search(built, key);
+
+    }
+
+    if (staged->count == 0) {  // handles unexpected empty trie error
+
+        fprintf(stderr, "error: cannot query an empty trie\n");
+        stg_destroy(staged);
+
+        exit(EXIT_FAILURE);
+
+    }
+
+    size_t lo = 0;
+    size_t hi = staged->count;
+
+    while (lo < hi) {  // counts the keys not above key
+
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (staged->items[mid].entry.key <= key)
+            lo = mid + 1;
+        else
+            hi = mid;
+
+    }
+
+    if (lo == 0)  // no predecessor
+        return &staged->items[0].entry;
+
+    if (lo == staged->count)  // no successor
+        return &staged->items[lo - 1].entry;
+
+    ikey_t pred = staged->items[lo - 1].entry.key;
+    ikey_t succ = staged->items[lo].entry.key;
+
+    return ((pred ^ key) <= (succ ^ key)) ? &staged->items[lo - 1].entry :
+        &staged->items[lo].entry;
+    // the neighbor sharing the longer prefix is the one the trie reaches
+
+}
+
+
+
+/// Fetches the built Trie.
+
+Trie stg_trie(Staged staged) {
+
+    return stg_load_built(staged);
+
+}
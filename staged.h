@@ -0,0 +1,112 @@
+// File: staged.h
+//
+// Description: header for a sorted-array stand-in that serves searches
+// while the full trie builds in the background
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef STAGED_H
+#define STAGED_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "trie.h"
+
+
+
+/// Staged is a pointer to the Staged ADT.
+typedef struct Staged_s * Staged;
+
+
+
+/// Create an empty Staged instance.
+///
+/// @param ext_show_value - the display function of the built Trie
+/// @param ext_delete_entry - the entry free function, also used on values
+///     dropped as duplicates
+///
+/// @return pointer to the Staged instance or NULL on failure
+
+Staged stg_create(void (*ext_show_value)(Entry entry, FILE * stream),
+    void (*ext_delete_entry)(Entry entry));
+
+
+
+/// Shape every Trie built from now on before it replaces the array: the
+/// background thread leaf-pushes it and builds its jump table as asked,
+/// so the sorted array serves until the finished layout is in place.
+///
+/// @param staged - a pointer to a Staged instance
+/// @param leaf_push - 1 to call ibt_leaf_push on each built Trie
+/// @param jump - 1 to call ibt_jump_build on each built Trie
+
+void stg_layout(Staged staged, char leaf_push, char jump);
+
+
+
+/// Destroy the instance, waiting for any background build to finish.
+///
+/// @param staged - a pointer to a Staged instance
+
+void stg_destroy(Staged staged);
+
+
+
+/// Add an entry to the next batch. As with ibt_insert, the first value
+/// added for a key is kept.
+///
+/// @param staged - a pointer to a Staged instance
+/// @param key - the entry key
+/// @param value - the entry value
+///
+/// @return 1 on success, 0 on allocation failure
+
+int stg_add(Staged staged, ikey_t key, ival_t value);
+
+
+
+/// Serve the batch: it is sorted and searched by binary search at once,
+/// while a background thread inserts it into a new Trie that replaces
+/// the array as soon as it is complete. Publishing again (a reload)
+/// waits for the previous build and drops the previous data.
+///
+/// @param staged - a pointer to a Staged instance
+///
+/// @return 1 on success, 0 if the batch is empty or the thread failed
+///     to start (the sorted array then keeps serving)
+
+int stg_publish(Staged staged);
+
+
+
+/// Search for the closest entry that matches key, giving the same answer
+/// as ibt_search. Entries found in the sorted array are only valid until
+/// the next stg_search or stg_publish, which may retire the array; call
+/// both from one thread.
+///
+/// @param staged - a pointer to a published Staged instance
+/// @param key - the key to find
+///
+/// @return the closest matching entry
+
+Entry stg_search(Staged staged, ikey_t key);
+
+
+
+/// Get the Trie once it has been swapped in.
+///
+/// @param staged - a pointer to a Staged instance
+///
+/// @return the built Trie, or NULL while the sorted array still serves
+
+Trie stg_trie(Staged staged);
+
+
+
+#endif  // STAGED_H
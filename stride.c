@@ -0,0 +1,304 @@
+// File: stride.c
+//
+// Description: module for a variable-stride optimizer for multibit tries
+//
+// Follows Srinivasan and Varghese's controlled prefix expansion. Let
+// nodes[m] be the number of m-bit prefixes holding at least two keys:
+// those are the binary trie nodes at depth m that a lookup cannot answer
+// without reading further bits. A level starting at depth m with stride s
+// then costs nodes[m] * 2^s slots, and the cheapest r-level trie covering
+// the first j bits obeys
+//
+//     T[1][j] = 2^j
+//     T[r][j] = min over m < j of T[r - 1][m] + nodes[m] * 2^(j - m)
+//
+// A trie may stop at any depth j with nodes[j] = 0, since no lookup goes
+// deeper. The table is 33 x 33 entries, so planning is dominated by the
+// single pass over the keys that counts nodes[].
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "stride.h"
+
+
+
+#define NOCOST (~0ULL)
+// marks an unreachable dynamic programming state
+
+
+
+const size_t VST_SLOTBYTES = 4;      /// < bytes per expanded table slot
+
+
+
+/// Stride planning state shared by the two budgets.
+struct Plan_s {
+
+    unsigned long long nodes[VST_MAXLEVELS + 1];
+    // prefixes of each length holding two or more keys
+
+    unsigned long long cost[VST_MAXLEVELS + 1][VST_MAXLEVELS + 1];
+    unsigned char from[VST_MAXLEVELS + 1][VST_MAXLEVELS + 1];
+    // T[r][j] in slots, and the start depth of its last level
+
+};
+
+
+
+/// Counts the binary trie nodes needing a table at each depth.
+/// Adjacent keys sharing c leading bits lie in the same m-bit prefix for
+/// every m <= c; a pair opens a new such prefix at each depth where the
+/// pair before it did not share one.
+///
+/// @param trie - the Trie instance
+/// @param plan - the planning state
+///
+/// @return 1 if the trie has keys, else 0
+
+static int vst_count_nodes(Trie trie, struct Plan_s * plan) {
+
+    long long starts[VST_MAXLEVELS + 2] = { 0 };
+    // difference array of group starts over depth
+
+    Iter iter;
+    Entry e = ibt_iter_seek(trie, &iter, 0);
+
+    if (e == NULL)  // nothing to plan for
+        return 0;
+
+    ikey_t prev_key = e->key;
+    int prev_shared = -1;
+
+    for (e = ibt_iter_next(&iter); e != NULL; e = ibt_iter_next(&iter)) {
+
+        ikey_t diff = prev_key ^ e->key;
+        int shared = 0;
+        ikey_t mask = 1;
+        mask <<= (BITSPERWORD - 1);
+
+        while (!(diff & mask)) {  // counts leading bits in common
+
+            mask >>= 1;
+            shared++;
+
+        }
+
+        if (shared > prev_shared) {  // opens groups at depths beyond the last
+
+            starts[prev_shared + 1]++;
+            starts[shared + 1]--;
+
+        }
+
+        prev_key = e->key;
+        prev_shared = shared;
+
+    }
+
+    long long running = 0;
+
+    for (size_t m = 0; m <= VST_MAXLEVELS; m++) {
+
+        running += starts[m];
+        plan->nodes[m] = (unsigned long long) running;
+
+    }
+
+    plan->nodes[0] = 1;
+    // the root table exists even for a single key
+
+    return 1;
+
+}
+
+
+
+/// Fills the dynamic programming table for up to max_levels levels.
+///
+/// @param plan - the planning state, with nodes[] counted
+/// @param max_levels - the level count to plan up to
+
+static void vst_solve(struct Plan_s * plan, size_t max_levels) {
+
+    for (size_t r = 0; r <= VST_MAXLEVELS; r++)
+        for (size_t j = 0; j <= VST_MAXLEVELS; j++)
+            plan->cost[r][j] = NOCOST;
+
+    for (size_t j = 1; j <= VST_MAXLEVELS; j++)  // the root level alone
+        plan->cost[1][j] = 1ULL << j;
+
+    for (size_t r = 2; r <= max_levels; r++) {
+
+        for (size_t j = r; j <= VST_MAXLEVELS; j++) {
+
+            for (size_t m = r - 1; m < j; m++) {  // last level starts at m
+
+                if (plan->cost[r - 1][m] == NOCOST)
+                    continue;
+
+                unsigned long long c = plan->cost[r - 1][m] +
+                    (plan->nodes[m] << (j - m));
+
+                if (c < plan->cost[r][j]) {
+
+                    plan->cost[r][j] = c;
+                    plan->from[r][j] = (unsigned char) m;
+
+                }
+
+            }
+
+        }
+
+    }
+
+}
+
+
+
+/// Finds the cheapest depth a trie of exactly r levels may end at.
+///
+/// @param plan - the solved planning state
+/// @param r - the level count
+///
+/// @return the end depth, or 0 if no r-level trie exists
+
+static size_t vst_best_end(struct Plan_s * plan, size_t r) {
+
+    size_t best = 0;
+
+    for (size_t j = r; j <= VST_MAXLEVELS; j++) {
+
+        if (plan->nodes[j] != 0 || plan->cost[r][j] == NOCOST)
+            continue;
+        // lookups still continue below depth j
+
+        if (best == 0 || plan->cost[r][j] < plan->cost[r][best])
+            best = j;
+
+    }
+
+    return best;
+
+}
+
+
+
+/// Traces an r-level trie ending at depth j back into a Strides layout.
+///
+/// @param plan - the solved planning state
+/// @param r - the level count
+/// @param j - the end depth
+/// @param out - the layout (passed as pointer)
+
+static void vst_trace(struct Plan_s * plan, size_t r, size_t j,
+    Strides * out) {
+
+    out->levels = r;
+    out->bytes = plan->cost[r][j] * VST_SLOTBYTES;
+    out->accesses = 0;
+
+    for (size_t level = r; level > 0; level--) {  // walks levels bottom up
+
+        size_t m = (level == 1) ? 0 : plan->from[level][j];
+
+        out->stride[level - 1] = (unsigned int) (j - m);
+        out->accesses += (double) plan->nodes[m] * (double) (1ULL << (32 - m)) /
+            4294967296.0;
+        // share of the key space that reaches the level's tables
+
+        j = m;
+
+    }
+
+}
+
+
+
+/// Plans the cheapest layout of at most max_levels levels.
+
+int vst_fit_depth(Trie trie, size_t max_levels, Strides * plan) {
+
+    struct Plan_s state;
+
+    if (max_levels == 0 || !vst_count_nodes(trie, &state))
+        return 0;
+
+    if (max_levels > VST_MAXLEVELS)
+        max_levels = VST_MAXLEVELS;
+
+    vst_solve(&state, max_levels);
+
+    size_t best_r = 0;
+    size_t best_j = 0;
+
+    for (size_t r = 1; r <= max_levels; r++) {  // fewer levels may be cheaper
+
+        size_t j = vst_best_end(&state, r);
+
+        if (j != 0 && (best_r == 0 ||
+            state.cost[r][j] < state.cost[best_r][best_j])) {
+
+            best_r = r;
+            best_j = j;
+
+        }
+
+    }
+
+    vst_trace(&state, best_r, best_j, plan);
+
+    return 1;
+
+}
+
+
+
+/// Plans the shallowest layout fitting a memory budget.
+
+int vst_fit_memory(Trie trie, unsigned long long max_bytes, Strides * plan) {
+
+    struct Plan_s state;
+
+    if (!vst_count_nodes(trie, &state))
+        return 0;
+
+    vst_solve(&state, VST_MAXLEVELS);
+
+    for (size_t r = 1; r <= VST_MAXLEVELS; r++) {  // shallowest first
+
+        size_t j = vst_best_end(&state, r);
+
+        if (j != 0 && state.cost[r][j] * VST_SLOTBYTES <= max_bytes) {
+
+            vst_trace(&state, r, j, plan);
+            return 1;
+
+        }
+
+    }
+
+    return 0;
+
+}
+
+
+
+/// Displays a layout.
+
+void vst_show(Strides * plan, FILE * stream) {
+
+    fprintf(stream, "strides:");
+
+    for (size_t level = 0; level < plan->levels; level++)
+        fprintf(stream, " %u", plan->stride[level]);
+
+    fprintf(stream, "\nstride bytes: %llu\n", plan->bytes);
+    fprintf(stream, "accesses per lookup: %.3f expected, %zu worst\n\n\n",
+        plan->accesses, plan->levels);
+
+}
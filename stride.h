@@ -0,0 +1,87 @@
+// File: stride.h
+//
+// Description: header for a variable-stride optimizer for multibit tries
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef STRIDE_H
+#define STRIDE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+
+
+
+#define VST_MAXLEVELS 32
+// a multibit trie over 32-bit keys has at most one level per bit
+
+
+
+/// Strides_s is an optimized multibit trie layout: the stride of each
+/// level and the cost of the trie built with them.
+struct Strides_s {
+
+    size_t levels;
+    unsigned int stride[VST_MAXLEVELS];
+    // bits consumed by each level, root first
+
+    unsigned long long bytes;
+    // table memory, at VST_SLOTBYTES per slot
+
+    double accesses;
+    // expected table reads per lookup over uniformly random keys
+
+};
+
+typedef struct Strides_s Strides;
+
+
+
+extern const size_t VST_SLOTBYTES;      /// < bytes per expanded table slot
+
+
+
+/// Choose per-level strides minimizing memory for a depth budget, by
+/// dynamic programming over the trie's key distribution (controlled
+/// prefix expansion). A table is needed below every prefix holding two
+/// or more keys; any other slot stores its answer directly.
+///
+/// @param trie - a pointer to a non-empty Trie instance
+/// @param max_levels - the most table reads a lookup may take
+/// @param plan - the chosen layout (passed as pointer)
+///
+/// @return 1 on success, 0 if the trie is empty or max_levels is 0
+
+int vst_fit_depth(Trie trie, size_t max_levels, Strides * plan);
+
+
+
+/// Choose per-level strides minimizing depth for a memory budget, taking
+/// the smallest layout among those with the fewest levels.
+///
+/// @param trie - a pointer to a non-empty Trie instance
+/// @param max_bytes - the most table memory allowed
+/// @param plan - the chosen layout (passed as pointer)
+///
+/// @return 1 on success, 0 if the trie is empty or no layout fits
+
+int vst_fit_memory(Trie trie, unsigned long long max_bytes, Strides * plan);
+
+
+
+/// Display a layout's strides, memory and accesses per lookup.
+///
+/// @param plan - the layout (passed as pointer)
+/// @param stream - the stream where display is output
+
+void vst_show(Strides * plan, FILE * stream);
+
+
+
+#endif  // STRIDE_H
@@ -8,6 +8,9 @@
 
 
 
+#include <stdint.h>
+#include <string.h>
+
 #include "trie.h"
 
 
@@ -24,6 +27,33 @@ struct Node_s {
     Node left;
     Node right;
 
+    Node lo;
+    Node hi;
+    // internal nodes: leftmost and rightmost leaf of the subtree
+    // leaf nodes: previous and next leaf in key order (NULL at the ends)
+
+    size_t count;
+    // internal nodes: number of (non-pushed) leaves in the subtree
+
+    char pushed;
+    // set on leaves created by leaf pushing, which share the entry of a
+    // real leaf and so never own (or free) it
+
+    char packed;
+    // set on nodes living in an arena (see ibt_relayout and
+    // ibt_use_arena), which are freed with it rather than one by one
+
+};
+
+
+
+/// HitSlot_s is one slot of the hotness side table: a node and the
+/// sampled searches that visited it (see ibt_profile).
+struct HitSlot_s {
+
+    Node node;
+    unsigned int hits;
+
 };
 
 
@@ -39,6 +69,31 @@ struct Trie_s {
     size_t height;
     // trie data
 
+    char leaf_pushed;
+    // leaf pushing state (see ibt_leaf_push)
+
+    Node * jump;
+    size_t jump_direct;
+    // top-level jump table and its slots answered directly (see
+    // ibt_jump_build)
+
+    size_t profile_period;
+    size_t profile_tick;
+    // hotness sampling state (see ibt_profile)
+
+    struct HitSlot_s * hits;
+    size_t hits_cap;
+    size_t hits_used;
+    // visit counts keyed by node address, kept only while sampling, so
+    // nodes carry no profiling state
+
+    Arena arena;
+    // contiguous node storage laid out by ibt_relayout
+
+    Arena pool;
+    int pool_flags;
+    // node and entry storage set up by ibt_use_arena (NULL for malloc)
+
     void (*ibt_show_value_w)(Entry entry, FILE * stream);
     // pointer to user-passed "show value" function
 
@@ -57,6 +112,9 @@ const size_t BITSPERBYTE = 8;        /// < number of bits in a byte
 const size_t BITSPERWORD = 32;       /// < number of bits in a word
 const size_t BYTESPERWORD = 4;       /// < number of bytes in a word
 const size_t RADIX = 256;            /// < number of possible byte values
+const size_t JUMPBITS = 16;          /// < key bits indexing the jump table
+
+static const size_t HITSMIN = 1024;  /// < initial hotness side table slots
 
 
 
@@ -74,6 +132,17 @@ Trie ibt_create(void (*ext_show_value)(Entry entry, FILE * stream),
     trie->num_nodes = 0;
     trie->leaf_nodes = 0;
     trie->height = 0;
+    trie->leaf_pushed = 0;
+    trie->jump = NULL;
+    trie->jump_direct = 0;
+    trie->profile_period = 0;
+    trie->profile_tick = 0;
+    trie->hits = NULL;
+    trie->hits_cap = 0;
+    trie->hits_used = 0;
+    trie->arena = NULL;
+    trie->pool = NULL;
+    trie->pool_flags = 0;
     // sets initial values
 
     trie->ibt_show_value_w = ext_show_value;
@@ -95,16 +164,18 @@ Trie ibt_create(void (*ext_show_value)(Entry entry, FILE * stream),
 
 static void ibt_delete_value(Trie trie, Node node) {
     
-    if (node->entry != NULL) {
+    if (node->entry != NULL && !node->pushed) {
 
         if (trie->ibt_delete_entry != NULL)  // calls user entry free function
             trie->ibt_delete_entry(node->entry);
 
-        free(node->entry);
+        if (trie->pool == NULL)  // pooled entries go with the pool
+            free(node->entry);
 
     }
 
-    free(node);
+    if (!node->packed)  // arena nodes go with the arena
+        free(node);
 
 }
 
@@ -135,23 +206,63 @@ static void ibt_destroy_rec(Trie trie, Node node) {
 void ibt_destroy(Trie trie) {
 
     ibt_destroy_rec(trie, trie->root);
+    free(trie->jump);
+    free(trie->hits);
+
+    if (trie->arena != NULL)
+        arn_destroy(trie->arena);
+
+    if (trie->pool != NULL)
+        arn_destroy(trie->pool);
+
     free(trie);
 
 }
 
 
 
+/// Allocates node or entry storage from the trie's pool, if it has one.
+///
+/// @param pool - the Arena to allocate from, or NULL to use malloc
+/// @param size - the number of bytes
+///
+/// @return the new storage
+
+static void * ibt_alloc(Arena pool, size_t size) {
+
+    void * mem = (pool == NULL) ? malloc(size) : arn_alloc(pool, size);
+
+    if (mem == NULL) {  // handles node allocation error
+
+        fprintf(stderr, "error: failed to allocate memory for trie node\n");
+        exit(EXIT_FAILURE);
+
+    }
+
+    return mem;
+
+}
+
+
+
 /// Creates a new empty node.
 ///
+/// @param pool - the Arena to allocate from, or NULL to use malloc
+///
 /// @return the new node
 
-static Node ibt_make_node(void) {
+static Node ibt_make_node(Arena pool) {
 
-    Node node = (Node) malloc(sizeof(struct Node_s));
+    Node node = (Node) ibt_alloc(pool, sizeof(struct Node_s));
 
     node->entry = NULL;
     node->left = NULL;
     node->right = NULL;
+    node->lo = NULL;
+    node->hi = NULL;
+    node->count = 0;
+    node->pushed = 0;
+    node->packed = (pool != NULL);
     // sets all node values to NULL (node is "empty")
 
     return node;
@@ -162,17 +273,23 @@ static Node ibt_make_node(void) {
 
 /// Makes a new leaf node.
 ///
+/// @param pool - the Arena to allocate from, or NULL to use malloc
 /// @param entry - data entry to put in node
 ///
 /// @return the new node
 
-static Node ibt_make_leaf(Entry entry) {
+static Node ibt_make_leaf(Arena pool, Entry entry) {
     
-    Node node = (Node) malloc(sizeof(struct Node_s));
+    Node node = (Node) ibt_alloc(pool, sizeof(struct Node_s));
     
     node->entry = entry;
     node->left = NULL;
     node->right = NULL;
+    node->lo = NULL;
+    node->hi = NULL;
+    node->count = 0;
+    node->pushed = 0;
+    node->packed = (pool != NULL);
     // leaf node has entry but no child nodes
 
     return node;
@@ -183,14 +300,15 @@ static Node ibt_make_leaf(Entry entry) {
 
 /// Creates new entry.
 ///
+/// @param pool - the Arena to allocate from, or NULL to use malloc
 /// @param key - the entry key
 /// @param value - the entry value pointer
 ///
 /// @return the new entry
 
-static Entry ibt_make_entry(ikey_t key, ival_t value) {
+static Entry ibt_make_entry(Arena pool, ikey_t key, ival_t value) {
 
-    Entry new_ent = (Entry) malloc(sizeof(struct Entry_s));
+    Entry new_ent = (Entry) ibt_alloc(pool, sizeof(struct Entry_s));
 
     new_ent->key = key;
     new_ent->value = value;
@@ -202,69 +320,146 @@ static Entry ibt_make_entry(ikey_t key, ival_t value) {
 
 
 
-/// Creates a trie branch to distinguish between new node and existing node.
+/// Gets the leftmost leaf of a subtree.
+///
+/// @param node - the subtree root
+///
+/// @return the leftmost leaf node
+
+static Node ibt_leftmost(Node node) {
+
+    if (node->left == NULL && node->right == NULL)  // node is itself a leaf
+        return node;
+
+    return node->lo;
+
+}
+
+
+
+/// Gets the rightmost leaf of a subtree.
+///
+/// @param node - the subtree root
+///
+/// @return the rightmost leaf node
+
+static Node ibt_rightmost(Node node) {
+
+    if (node->left == NULL && node->right == NULL)  // node is itself a leaf
+        return node;
+
+    return node->hi;
+
+}
+
+
+
+/// Threads a new leaf into the key-ordered leaf list.
+///
+/// @param leaf - the new leaf
+/// @param prev - the leaf preceding it (or NULL)
+/// @param next - the leaf following it (or NULL)
+
+static void ibt_link_leaf(Node leaf, Node prev, Node next) {
+
+    leaf->lo = prev;
+    leaf->hi = next;
+
+    if (prev != NULL)
+        prev->hi = leaf;
+
+    if (next != NULL)
+        next->lo = leaf;
+
+}
+
+
+
+/// Creates a trie branch to distinguish between new leaf and existing leaf.
+/// The existing leaf keeps its node, so leaf links to it stay valid.
 ///
-/// @param node - the starting branch node
-/// @param key1 - the key passed originally that needs to be inserted
-/// @param key2 - the key value associated with the already existing node
+/// @param pool - the Arena to allocate from, or NULL to use malloc
+/// @param slot - the child pointer currently holding the existing leaf
+/// @param leaf - the new leaf that needs to be inserted
+/// @param old - the already existing leaf
 /// @param mask - bit mask used to view individual bits
-/// @param val1 - the value passed originally that needs to be inserted
-/// @param entry2 - the entry associated with the existing node
 /// @param nc - node count increment (passed as pointer)
 /// @param bh - branch height increment (passed as pointer)
 
-static void ibt_make_branch(Node node, ikey_t key1, ikey_t key2, ikey_t mask,
-    ival_t val1, Entry entry2, size_t * nc, size_t * bh) {
-    
-    Node cur = node;
+static void ibt_make_branch(Arena pool, Node * slot, Node leaf, Node old,
+    ikey_t mask, size_t * nc, size_t * bh) {
+
+    ikey_t key1 = leaf->entry->key;
+    ikey_t key2 = old->entry->key;
+
+    Node min = (key1 < key2) ? leaf : old;
+    Node max = (key1 < key2) ? old : leaf;
+    // every branch node created here spans exactly these two leaves
+
+    (*nc)++;
+    // accounts for the new leaf
 
     while (1) {  // branch creation loop
 
+        Node cur = ibt_make_node(pool);
+        cur->lo = min;
+        cur->hi = max;
+        cur->count = 2;
+        *slot = cur;
+
+        (*nc)++;
+        (*bh)++;
+
         ikey_t bit1 = key1 & mask;
         ikey_t bit2 = key2 & mask;
 
         if (bit1 == bit2) {  // checked bits are the same
 
-            (*nc)++;
-            (*bh)++;
+            slot = (bit1 == 0) ? &cur->left : &cur->right;
+            mask >>= 1;
+
+            continue;
+
+        }
 
-            if (bit1 == 0) {  // similar bits are 1's
+        if (bit1 == 0) {  // key1 is leftmost value
 
-                cur->left = ibt_make_node();
-                cur = cur->left;
-                mask >>= 1;
+            cur->left = leaf;
+            cur->right = old;
 
-                continue;
+        } else {  // key2 is leftmost value
 
-            } else {  // similar bits are 0's
+            cur->left = old;
+            cur->right = leaf;
 
-                cur->right = ibt_make_node();
-                cur = cur->right;
-                mask >>= 1;
-                continue;
+        }
 
-            }
+        return;
 
-        } else {  // checked bits are different
+    }
 
-            (*nc) += 2;
-            (*bh)++;
+}
 
-            if (bit1 == 0) {  // key1 is leftmost value
 
-                cur->left = ibt_make_leaf(ibt_make_entry(key1, val1));
-                cur->right = ibt_make_leaf(entry2);
 
-            } else {  // key2 is leftmost value
+/// Undoes the subtree count increments of an insertion whose key was
+/// already present, by walking the same internal nodes again.
+///
+/// @param trie - the Trie instance
+/// @param key - the duplicate key
 
-                cur->left = ibt_make_leaf(entry2);
-                cur->right = ibt_make_leaf(ibt_make_entry(key1, val1));
-            
-            }
+static void ibt_uncount_iter(Trie trie, ikey_t key) {
 
-            return;
+    ikey_t mask = 1;
+    mask <<= (BITSPERWORD - 1);
 
-        }
+    Node cur = trie->root;
+
+    while (cur->left != NULL || cur->right != NULL) {  // stops at the leaf
+
+        cur->count--;
+        cur = (key & mask) ? cur->right : cur->left;
+        mask >>= 1;
 
     }
 
@@ -274,149 +469,195 @@ static void ibt_make_branch(Node node, ikey_t key1, ikey_t key2, ikey_t mask,
 
 /// Inserts nodes into the Trie instance using iteration.
 /// In this instance, iteration is used to maximize performance.
+/// Subtree extremal leaves are updated on the way down, and the new
+/// leaf is threaded between its neighbors once its position is known.
 ///
 /// @param trie - the Trie instance
-/// @param key - the key being inserted
-/// @param value - the value being inserted
+/// @param leaf - the new leaf being inserted
+/// @param bh - branch height increment (passed as pointer)
+///
+/// @return 1 if the leaf was inserted, 0 if the key was already present
+
+static char ibt_insert_iter(Trie trie, Node leaf, size_t * bh) {
 
-static void ibt_insert_iter(Trie trie, ikey_t key, ival_t value, size_t * bh) {
+    ikey_t key = leaf->entry->key;
 
     ikey_t mask = 1;
     mask <<= (BITSPERWORD - 1);
     // creates mask
 
+    Node * slot = &trie->root;
     Node cur = trie->root;
 
     while (1) {  // insertion loop
 
         if (cur->right == NULL && cur->left == NULL) {  // leaf node reached
 
-            if (key != cur->entry->key) {  // make branch if keys are different
+            if (key == cur->entry->key) {  // key already present
+
+                ibt_uncount_iter(trie, key);
+                return 0;
+
+            }
+
+            if (key < cur->entry->key) {  // new leaf precedes existing leaf
                 
-                Entry e_old = cur->entry;
-                cur->entry = NULL;
+                ibt_link_leaf(leaf, cur->lo, cur);
+
+            } else {  // new leaf follows existing leaf
+
+                ibt_link_leaf(leaf, cur, cur->hi);
 
-                ibt_make_branch(cur, key, e_old->key, mask, value, e_old,
-                    &trie->num_nodes, bh);
-            
             }
 
-            return;
+            ibt_make_branch(trie->pool, slot, leaf, cur, mask,
+                &trie->num_nodes, bh);
+
+            return 1;
 
         }
 
+        cur->count++;
+        // undone by ibt_uncount_iter if the key turns out to be present
+
+        if (key < cur->lo->entry->key)  // new leaf is leftmost in subtree
+            cur->lo = leaf;
+
+        if (key > cur->hi->entry->key)  // new leaf is rightmost in subtree
+            cur->hi = leaf;
+
         ikey_t bit = key & mask;
+        (*bh)++;
 
         if (bit == 0) {  // bit is 0
 
-            (*bh)++;
-
             if (cur->left == NULL) {  // no current left node (make one)
 
-                cur->left = ibt_make_leaf(ibt_make_entry(key, value));
+                Node next = ibt_leftmost(cur->right);
+                ibt_link_leaf(leaf, next->lo, next);
+
+                cur->left = leaf;
                 trie->num_nodes++;
 
-                return;
+                return 1;
 
             }
 
-            cur = cur->left;
-            mask >>= 1;
-            continue;
+            slot = &cur->left;
 
         } else {  // bit is 1
 
-            (*bh)++;
-
             if (cur->right == NULL) {  // no current right node (make one)
 
-                cur->right = ibt_make_leaf(ibt_make_entry(key, value));
+                Node prev = ibt_rightmost(cur->left);
+                ibt_link_leaf(leaf, prev, prev->hi);
+
+                cur->right = leaf;
                 trie->num_nodes++;
 
-                return;
+                return 1;
 
             }
 
-            cur = cur->right;
-            mask >>= 1;
-            continue;
+            slot = &cur->right;
 
         }
 
+        cur = *slot;
+        mask >>= 1;
+
     }
 
 }
 
 
 
-/// Inserts a new node into the Trie instance.
+/// Removes all pushed leaves below a node, restoring the sparse trie.
+///
+/// @param trie - the Trie instance
+/// @param node - the current node being recursed upon
 
-void ibt_insert(Trie trie, ikey_t key, ival_t value) {
+static void ibt_unpush_rec(Trie trie, Node node) {
 
-    trie->leaf_nodes++;
+    if (node == NULL || (node->left == NULL && node->right == NULL))
+        return;
 
-    if (trie->root == NULL) {  // handles empty tree case
+    if (node->left->pushed) {  // drops pushed left leaf
 
-        trie->root = ibt_make_leaf(ibt_make_entry(key, value));
-        trie->height = 1;
-        trie->num_nodes = 1;
+        if (!node->left->packed)
+            free(node->left);
 
-        return;
+        node->left = NULL;
 
-    }
+    } else if (node->right->pushed) {  // drops pushed right leaf
 
-    size_t bh = 1;
-    // holds the current branch height
+        if (!node->right->packed)
+            free(node->right);
 
-    ibt_insert_iter(trie, key, value, &bh);
+        node->right = NULL;
 
-    if (bh > trie->height)  // updates trie height
-        trie->height = bh;
+    }
+
+    ibt_unpush_rec(trie, node->left);
+    ibt_unpush_rec(trie, node->right);
 
 }
 
 
 
-/// Finds the closest match when an exact search result not found.
-///
-/// @param node - the current node being recursed upon
-/// @param mode - specifies "left" or "right" mode depending on the
-///     values of previous node traversals
-///
-/// @return the entry from the closest matching node
+/// Inserts a new node into the Trie instance.
 
-static Entry ibt_closest_match_rec(Node node, char mode) {
-    
-    if (node->left == NULL && node->right == NULL)  // closest leaf node reached
-        return node->entry;
+void ibt_insert(Trie trie, ikey_t key, ival_t value) {
 
-    if (mode == 'l') {  // left "mode" favors moving left down trie
+    if (trie->jump != NULL) {  // slot answers may change, so drop the table
 
-        if (node->left != NULL) {
-            
-            return ibt_closest_match_rec(node->left, 'l');
+        free(trie->jump);
+        trie->jump = NULL;
+        trie->jump_direct = 0;
 
-        } else {
+    }
 
-            return ibt_closest_match_rec(node->right, 'l');
+    if (trie->leaf_pushed) {  // pushed answers may change, so undo pushing
 
-        }
+        ibt_unpush_rec(trie, trie->root);
+        trie->leaf_pushed = 0;
 
-    } else {  // right "mode" favors moving right down trie
+    }
 
-        if (node->right != NULL) {
+    Node leaf = ibt_make_leaf(trie->pool,
+        ibt_make_entry(trie->pool, key, value));
 
-            return ibt_closest_match_rec(node->right, 'r');
+    if (trie->root == NULL) {  // handles empty tree case
 
-        } else {
+        trie->root = leaf;
+        trie->height = 1;
+        trie->num_nodes = 1;
+        trie->leaf_nodes = 1;
+
+        return;
 
-            return ibt_closest_match_rec(node->left, 'r');
+    }
+
+    size_t bh = 1;
+    // holds the current branch height
+
+    if (!ibt_insert_iter(trie, leaf, &bh)) {  // discards duplicate key leaf
+
+        if (trie->pool == NULL) {  // pooled storage is reclaimed with the pool
+
+            free(leaf->entry);
+            free(leaf);
 
         }
 
+        return;
+
     }
 
-    return NULL;
+    trie->leaf_nodes++;
+
+    if (bh > trie->height)  // updates trie height
+        trie->height = bh;
 
 }
 
@@ -428,26 +669,26 @@ static Entry ibt_closest_match_rec(Node node, char mode) {
 /// @param key - the key to search for
 /// @param mask - the bit mask to access key bits
 ///
-/// @return the entry from the closest matching node
+/// @return the closest matching leaf node
 
-static Entry ibt_search_rec(Node node, ikey_t key, ikey_t mask) {
+static Node ibt_search_rec(Node node, ikey_t key, ikey_t mask) {
     
     if (node->left == NULL && node->right == NULL)  // leaf node reached
-        return node->entry;
+        return node;
 
     ikey_t bit_rep = key & mask;
 
     if (bit_rep == 0) {  // bit is 0
 
         if (node->left == NULL)  // no exact match found
-            return ibt_closest_match_rec(node->right, 'l');
+            return ibt_leftmost(node->right);
 
         return ibt_search_rec(node->left, key, mask >> 1);
 
     } else {  // bit is 1
 
         if (node->right == NULL)  // no exact match found
-            return ibt_closest_match_rec(node->left, 'r');
+            return ibt_rightmost(node->left);
 
         return ibt_search_rec(node->right, key, mask >> 1);
 
@@ -459,104 +700,901 @@ static Entry ibt_search_rec(Node node, ikey_t key, ikey_t mask) {
 
 
 
-/// Searches a Trie instance to find the closest match to a key.
+/// Searches a leaf-pushed trie, where every internal node has both children
+/// and so each descent ends at a leaf holding the answer.
+///
+/// @param node - the trie root
+/// @param key - the key to search for
+/// @param mask - the bit mask to access key bits
+///
+/// @return the real leaf standing behind the leaf reached
 
-Entry ibt_search(Trie trie, ikey_t key) {
+static Node ibt_search_pushed(Node node, ikey_t key, ikey_t mask) {
+
+    while (node->left != NULL) {  // internal nodes always have two children
+
+        node = (key & mask) ? node->right : node->left;
+        mask >>= 1;
+
+    }
+
+    return node->pushed ? node->lo : node;
+
+}
+
+
+
+/// Finds the closest matching leaf in a non-empty trie.
+/// The leaf found is always the key's predecessor or successor.
+///
+/// @param trie - the Trie instance
+/// @param key - the key to search for
+///
+/// @return the closest matching leaf node
+
+static Node ibt_search_node(Trie trie, ikey_t key) {
 
     ikey_t mask = 1;
-    mask <<= (BITSPERWORD - 1);
+    Node start = trie->root;
 
-    if (trie->root == NULL) {  // handles unexpected empty trie error
+    if (trie->jump != NULL) {  // starts JUMPBITS levels down, or finishes
 
-        fprintf(stderr, "error: cannot query an empty trie\n");
-        ibt_destroy(trie);
+        start = trie->jump[key >> (BITSPERWORD - JUMPBITS)];
 
-        exit(EXIT_FAILURE);
+        if (start->left == NULL && start->right == NULL)  // direct answer
+            return start;
 
-    }
+        mask <<= (BITSPERWORD - JUMPBITS - 1);
+
+    } else
+        mask <<= (BITSPERWORD - 1);
 
-    return ibt_search_rec(trie->root, key, mask);
+    if (trie->leaf_pushed)  // fixed walk with no closest-match phase
+        return ibt_search_pushed(start, key, mask);
+
+    return ibt_search_rec(start, key, mask);
 
 }
 
 
 
-/// Fetches the trie size.
+/// Finds the side table slot of a node: the slot holding it, or the
+/// empty slot where it would go.
+///
+/// @param slots - the table
+/// @param cap - the number of slots (a power of two)
+/// @param node - the node to find
+///
+/// @return the slot
 
-size_t ibt_size(Trie trie) {
+static struct HitSlot_s * ibt_hits_slot(struct HitSlot_s * slots, size_t cap,
+    Node node) {
 
-    return trie->leaf_nodes;
+    size_t i = (size_t) (((uintptr_t) node >> 4) * 0x9e3779b97f4a7c15ULL >>
+        32) & (cap - 1);
+    // Fibonacci hashing of the address, dropping its alignment bits
+
+    while (slots[i].node != NULL && slots[i].node != node)  // linear probing
+        i = (i + 1) & (cap - 1);
+
+    return &slots[i];
 
 }
 
 
 
-/// Calculates the number of internal trie nodes.
+/// Gets the sampled visits to a node.
+///
+/// @param trie - the Trie instance
+/// @param node - the node
+///
+/// @return the visit count (0 when not sampling)
 
-size_t ibt_node_count(Trie trie) {
+static unsigned int ibt_hits(Trie trie, Node node) {
 
-    return trie->num_nodes - trie->leaf_nodes;
+    if (trie->hits == NULL)
+        return 0;
+
+    struct HitSlot_s * slot = ibt_hits_slot(trie->hits, trie->hits_cap, node);
+
+    return (slot->node == node) ? slot->hits : 0;
 
 }
 
 
 
-/// Fetches the trie height.
+/// Credits a node with a sampled visit, doubling the side table once it
+/// is half full. A visit is dropped if the table cannot grow.
+///
+/// @param trie - the Trie instance
+/// @param node - the node visited
 
-size_t ibt_height(Trie trie) {
+static void ibt_hit(Trie trie, Node node) {
 
-    return trie->height;
+    if (2 * (trie->hits_used + 1) > trie->hits_cap) {  // grows the table
 
-}
+        size_t cap = 2 * trie->hits_cap;
+        struct HitSlot_s * slots = (struct HitSlot_s *) calloc(cap,
+            sizeof(struct HitSlot_s));
 
+        if (slots == NULL)  // handles memory error, keeps the counts so far
+            return;
 
+        for (size_t i = 0; i < trie->hits_cap; i++)
+            if (trie->hits[i].node != NULL)
+                *ibt_hits_slot(slots, cap, trie->hits[i].node) =
+                    trie->hits[i];
 
-/// Acts as a wrapper for user-passed display function to print an entry.
+        free(trie->hits);
+        trie->hits = slots;
+        trie->hits_cap = cap;
 
-void ibt_show_value(Trie trie, Entry entry, FILE * stream) {
+    }
 
-    if (trie->ibt_show_value_w == NULL) {  // handles incorrect ADT usage error
+    struct HitSlot_s * slot = ibt_hits_slot(trie->hits, trie->hits_cap, node);
 
-        fprintf(stderr, "error: no user display function defined\n");
-        return;
+    if (slot->node == NULL) {  // first visit
+
+        slot->node = node;
+        trie->hits_used++;
 
     }
-    // if user does not pass a display function pointer on creation an error
-    // message displays; the program will still continue to run, though
 
-    trie->ibt_show_value_w(entry, stream);
-    // cals user-defined display function
+    slot->hits++;
 
 }
 
 
 
-/// Recursively displays the elements of the Trie instance.
+/// Counts a sampled search: every node on the search path, and the leaf
+/// holding the answer, is credited with a hit.
 ///
-/// @param trie - the Trie instance to display
-/// @param node - current node being recursed upon
-/// @param stream - the stream where display is output
+/// @param trie - the Trie instance
+/// @param key - the key searched for
 
-static void ibt_show_rec(Trie trie, Node node, FILE * stream) {
+static void ibt_profile_walk(Trie trie, ikey_t key) {
 
-    if (node == NULL)
-        return;
+    Node node = trie->root;
+
+    ikey_t mask = 1;
+    mask <<= (BITSPERWORD - 1);
+
+    while (node->left != NULL || node->right != NULL) {  // descent loop
+
+        ibt_hit(trie, node);
+        Node next = (key & mask) ? node->right : node->left;
+
+        if (next == NULL) {  // falls back to the nearest leaf
+
+            next = (key & mask) ? ibt_rightmost(node->left) :
+                ibt_leftmost(node->right);
+
+            ibt_hit(trie, next);
+            return;
 
-    ibt_show_rec(trie, node->left, stream);
+        }
+
+        node = next;
+        mask >>= 1;
+
+    }
 
-    if (node->entry != NULL)  // shows leaf values
-        ibt_show_value(trie, node->entry, stream);
+    ibt_hit(trie, node);
 
-    ibt_show_rec(trie, node->right, stream);
+    if (node->pushed)  // the real leaf is read for the answer
+        ibt_hit(trie, node->lo);
 
 }
 
 
 
-/// Displays trie data.
+/// Searches a Trie instance to find the closest match to a key.
 
-void ibt_show(Trie trie, FILE * stream) {
+Entry ibt_search(Trie trie, ikey_t key) {
+
+    if (trie->root == NULL) {  // handles unexpected empty trie error
+
+        fprintf(stderr, "error: cannot query an empty trie\n");
+        ibt_destroy(trie);
+
+        exit(EXIT_FAILURE);
+
+    }
+
+    if (trie->profile_period != 0 &&
+        ++trie->profile_tick % trie->profile_period == 0)
+        ibt_profile_walk(trie, key);
+    // samples one search in every profile_period
+
+    return ibt_search_node(trie, key)->entry;
+
+}
+
+
+
+/// Finds the entry with the greatest key not above the key given.
+
+Entry ibt_predecessor(Trie trie, ikey_t key) {
+
+    if (trie->root == NULL)  // empty trie has no predecessor
+        return NULL;
+
+    Node leaf = ibt_search_node(trie, key);
+
+    if (leaf->entry->key > key)  // closest match is the successor
+        leaf = leaf->lo;
+
+    return (leaf == NULL) ? NULL : leaf->entry;
+
+}
+
+
+
+/// Finds the entry with the smallest key not below the key given.
+
+Entry ibt_successor(Trie trie, ikey_t key) {
+
+    if (trie->root == NULL)  // empty trie has no successor
+        return NULL;
+
+    Node leaf = ibt_search_node(trie, key);
+
+    if (leaf->entry->key < key)  // closest match is the predecessor
+        leaf = leaf->hi;
+
+    return (leaf == NULL) ? NULL : leaf->entry;
+
+}
+
+
+
+/// Positions an iterator at the first entry not below a key.
+
+Entry ibt_iter_seek(Trie trie, Iter * iter, ikey_t key) {
+
+    iter->node = NULL;
+
+    if (trie->root == NULL)  // empty trie has nothing to iterate
+        return NULL;
+
+    Node leaf = ibt_search_node(trie, key);
+
+    if (leaf->entry->key < key)  // closest match is the predecessor
+        leaf = leaf->hi;
+
+    iter->node = leaf;
+
+    return (leaf == NULL) ? NULL : leaf->entry;
+
+}
+
+
+
+/// Advances an iterator along the leaf list.
+
+Entry ibt_iter_next(Iter * iter) {
+
+    if (iter->node == NULL)  // iterator already exhausted
+        return NULL;
+
+    iter->node = iter->node->hi;
+
+    return (iter->node == NULL) ? NULL : iter->node->entry;
+
+}
+
+
+
+/// Visits each entry in a key range using an iterator.
+
+size_t ibt_range(Trie trie, ikey_t lo, ikey_t hi,
+    void (*visit)(Entry entry, void * context), void * context) {
+
+    Iter iter;
+    size_t count = 0;
+
+    if (lo > hi)  // empty range
+        return 0;
+
+    for (Entry e = ibt_iter_seek(trie, &iter, lo); e != NULL && e->key <= hi;
+        e = ibt_iter_next(&iter)) {
+
+        visit(e, context);
+        count++;
+
+    }
+
+    return count;
+
+}
+
+
+
+/// Gets the number of entries in a subtree.
+///
+/// @param node - the subtree root
+///
+/// @return the number of real leaves below (or at) node
+
+static size_t ibt_count(Node node) {
+
+    if (node->left == NULL && node->right == NULL)  // pushed leaves are copies
+        return !node->pushed;
+
+    return node->count;
+
+}
+
+
+
+/// Counts entries with keys less than key by summing left subtree counts.
+
+size_t ibt_rank(Trie trie, ikey_t key) {
+
+    ikey_t mask = 1;
+    mask <<= (BITSPERWORD - 1);
+
+    size_t rank = 0;
+    Node cur = trie->root;
+
+    if (cur == NULL)  // empty trie
+        return 0;
+
+    while (cur->left != NULL || cur->right != NULL) {  // descent loop
+
+        if ((key & mask) == 0) {  // bit is 0: right subtree is all greater
+
+            if (cur->left == NULL)
+                return rank;
+
+            cur = cur->left;
+
+        } else {  // bit is 1: left subtree is all smaller
+
+            if (cur->left != NULL)
+                rank += ibt_count(cur->left);
+
+            if (cur->right == NULL)
+                return rank;
+
+            cur = cur->right;
+
+        }
+
+        mask >>= 1;
+
+    }
+
+    return rank + (!cur->pushed && cur->entry->key < key);
+
+}
+
+
+
+/// Finds the entry at a position in key order by descending on counts.
+
+Entry ibt_select(Trie trie, size_t index) {
+
+    if (index >= trie->leaf_nodes)  // past the last entry
+        return NULL;
+
+    Node cur = trie->root;
+
+    while (cur->left != NULL || cur->right != NULL) {  // descent loop
+
+        size_t left_count = (cur->left == NULL) ? 0 : ibt_count(cur->left);
+
+        if (index < left_count) {  // entry is in the left subtree
+
+            cur = cur->left;
+
+        } else {  // entry is in the right subtree
+
+            index -= left_count;
+            cur = cur->right;
+
+        }
+
+    }
+
+    return cur->entry;
+
+}
+
+
+
+/// Makes a pushed leaf sharing the entry of an existing leaf.
+/// Both leaf links of a pushed leaf point at the real leaf it stands for.
+///
+/// @param pool - the Arena to allocate from, or NULL to use malloc
+/// @param real - the leaf a search ending at this leaf should return
+///
+/// @return the new node
+
+static Node ibt_make_pushed(Arena pool, Node real) {
+
+    Node node = ibt_make_leaf(pool, real->entry);
+    node->lo = real;
+    node->hi = real;
+    node->pushed = 1;
+
+    return node;
+
+}
+
+
+
+/// Recursively fills each missing child with the closest-match answer
+/// that a search falling off the trie at that point would return.
+///
+/// @param trie - the Trie instance
+/// @param node - the current node being recursed upon
+
+static void ibt_leaf_push_rec(Trie trie, Node node) {
+
+    if (node == NULL || (node->left == NULL && node->right == NULL))
+        return;
+
+    if (node->left == NULL) {  // left misses fall back to the right subtree
+
+        node->left = ibt_make_pushed(trie->pool,
+            ibt_leftmost(node->right));
+
+    } else if (node->right == NULL) {  // right misses fall back to the left
+
+        node->right = ibt_make_pushed(trie->pool,
+            ibt_rightmost(node->left));
+
+    }
+
+    ibt_leaf_push_rec(trie, node->left);
+    ibt_leaf_push_rec(trie, node->right);
+
+}
+
+
+
+/// Leaf-pushes the trie so that searches never need a fallback.
+
+void ibt_leaf_push(Trie trie) {
+
+    if (trie->leaf_pushed)  // already pushed
+        return;
+
+    ibt_leaf_push_rec(trie, trie->root);
+    trie->leaf_pushed = 1;
+
+}
+
+
+
+/// Recursively fills the jump table slots below a node. A node at depth
+/// JUMPBITS owns one slot; a leaf, or a missing child, above that depth
+/// answers every slot of its key interval directly.
+///
+/// @param trie - the Trie instance
+/// @param node - the current node being recursed upon
+/// @param depth - the depth of node
+/// @param prefix - the leading depth bits of every key below node
+
+static void ibt_jump_rec(Trie trie, Node node, size_t depth, size_t prefix) {
+
+    size_t first = prefix << (JUMPBITS - depth);
+    size_t span = (size_t) 1 << (JUMPBITS - depth);
+    Node answer = NULL;
+
+    if (node->left == NULL && node->right == NULL)  // leaf covers the interval
+        answer = node->pushed ? node->lo : node;
+
+    else if (depth == JUMPBITS) {  // search continues from this node
+
+        trie->jump[first] = node;
+        return;
+
+    }
+
+    if (answer != NULL) {
+
+        for (size_t i = 0; i < span; i++)
+            trie->jump[first + i] = answer;
+
+        trie->jump_direct += span;
+        return;
+
+    }
+
+    size_t half = span / 2;
+
+    if (node->left == NULL) {  // left misses fall back to the right subtree
+
+        answer = ibt_leftmost(node->right);
+
+        for (size_t i = 0; i < half; i++)
+            trie->jump[first + i] = answer;
+
+        trie->jump_direct += half;
+
+    } else
+        ibt_jump_rec(trie, node->left, depth + 1, prefix << 1);
+
+    if (node->right == NULL) {  // right misses fall back to the left subtree
+
+        answer = ibt_rightmost(node->left);
+
+        for (size_t i = half; i < span; i++)
+            trie->jump[first + i] = answer;
+
+        trie->jump_direct += half;
+
+    } else
+        ibt_jump_rec(trie, node->right, depth + 1, (prefix << 1) | 1);
+
+}
+
+
+
+/// Builds the top-level jump table of the trie.
+
+char ibt_jump_build(Trie trie) {
+
+    if (trie->root == NULL)  // nothing to jump into
+        return 0;
+
+    Node * jump = (Node *) realloc(trie->jump,
+        ((size_t) 1 << JUMPBITS) * sizeof(Node));
+
+    if (jump == NULL)  // signifies an allocation failure
+        return 0;
+
+    trie->jump = jump;
+    trie->jump_direct = 0;
+    ibt_jump_rec(trie, trie->root, 0, 0);
+
+    return 1;
+
+}
+
+
+
+/// Fetches the number of jump table slots answered directly.
+
+size_t ibt_jump_direct(Trie trie) {
+
+    return trie->jump_direct;
+
+}
+
+
+
+/// Starts, changes or stops hotness sampling.
+
+void ibt_profile(Trie trie, size_t period) {
+
+    if (period != 0 && trie->hits == NULL) {  // creates the side table
+
+        trie->hits = (struct HitSlot_s *) calloc(HITSMIN,
+            sizeof(struct HitSlot_s));
+
+        if (trie->hits == NULL)  // handles memory error: no sampling
+            period = 0;
+
+        trie->hits_cap = HITSMIN;
+        trie->hits_used = 0;
+
+    }
+
+    if (period == 0) {  // drops the counts with the table
+
+        free(trie->hits);
+        trie->hits = NULL;
+        trie->hits_cap = 0;
+        trie->hits_used = 0;
+
+    }
+
+    trie->profile_period = period;
+    trie->profile_tick = 0;
+
+}
+
+
+
+/// Counts the nodes of a subtree.
+///
+/// @param node - the current node being recursed upon
+///
+/// @return the number of nodes, leaves included
+
+static size_t ibt_count_nodes(Node node) {
+
+    if (node == NULL)
+        return 0;
+
+    return 1 + ibt_count_nodes(node->left) + ibt_count_nodes(node->right);
+
+}
+
+
+
+/// Copies the nodes of a subtree that are hot (or cold) into the arena,
+/// hotter child first, so the busiest paths end up in consecutive nodes.
+/// Each copied node is left holding its new address in its hi field, and
+/// its count goes to the copy in the aged table, halved.
+///
+/// @param trie - the Trie instance
+/// @param node - the current node being recursed upon
+/// @param arena - the new node storage
+/// @param next - the next free arena position (passed as pointer)
+/// @param hot - 1 to copy nodes with hits, 0 to copy the rest
+/// @param aged - the side table for the copies (NULL to drop the counts)
+
+static void ibt_pack_rec(Trie trie, Node node, Node arena, size_t * next,
+    char hot, struct HitSlot_s * aged) {
+
+    if (node == NULL)
+        return;
+
+    unsigned int hits = ibt_hits(trie, node);
+
+    if ((hits != 0) == hot) {  // copies and forwards the node
+
+        Node copy = &arena[(*next)++];
+
+        *copy = *node;
+        copy->packed = 1;
+
+        if (aged != NULL && hits / 2 != 0) {  // ages the count
+
+            struct HitSlot_s * slot = ibt_hits_slot(aged, trie->hits_cap,
+                copy);
+
+            slot->node = copy;
+            slot->hits = hits / 2;
+
+        }
+        // ages the counts so later layouts follow shifting traffic
+
+        node->hi = copy;
+
+    }
+
+    Node first = node->left;
+    Node second = node->right;
+
+    if (second != NULL && (first == NULL ||
+        ibt_hits(trie, second) > ibt_hits(trie, first))) {
+
+        first = node->right;
+        second = node->left;
+
+    }
+    // visits the hotter child first
+
+    ibt_pack_rec(trie, first, arena, next, hot, aged);
+    ibt_pack_rec(trie, second, arena, next, hot, aged);
+
+}
+
+
+
+/// Frees the nodes of a subtree that were allocated one by one.
+///
+/// @param node - the current node being recursed upon
+
+static void ibt_free_nodes(Node node) {
+
+    if (node == NULL)
+        return;
+
+    ibt_free_nodes(node->left);
+    ibt_free_nodes(node->right);
+
+    if (!node->packed)
+        free(node);
+
+}
+
+
+
+/// Repacks every node into one arena in hotness order.
+
+size_t ibt_relayout(Trie trie) {
+
+    if (trie->root == NULL)  // nothing to lay out
+        return 0;
+
+    size_t total = ibt_count_nodes(trie->root);
+    Arena storage = arn_create(trie->pool_flags);
+    Node arena = NULL;
+
+    if (storage != NULL)
+        arena = (Node) arn_alloc(storage, total * sizeof(struct Node_s));
+
+    if (arena == NULL) {  // signifies an allocation failure
+
+        if (storage != NULL)
+            arn_destroy(storage);
+
+        return 0;
+
+    }
+
+    struct HitSlot_s * aged = NULL;
+
+    if (trie->hits != NULL)  // the copies' counts, at most as many as now
+        aged = (struct HitSlot_s *) calloc(trie->hits_cap,
+            sizeof(struct HitSlot_s));
+
+    size_t next = 0;
+    ibt_pack_rec(trie, trie->root, arena, &next, 1, aged);
+
+    size_t hot = next;
+    ibt_pack_rec(trie, trie->root, arena, &next, 0, aged);
+
+    if (trie->hits != NULL) {  // counts now follow the copies
+
+        if (aged == NULL) {  // handles memory error: counting restarts
+
+            aged = trie->hits;
+            memset(aged, 0, trie->hits_cap * sizeof(struct HitSlot_s));
+
+        } else {
+
+            free(trie->hits);
+
+        }
+
+        trie->hits = aged;
+        trie->hits_used = 0;
+
+        for (size_t i = 0; i < trie->hits_cap; i++)
+            trie->hits_used += (aged[i].node != NULL);
+
+    }
+
+    for (size_t i = 0; i < total; i++) {  // redirects links to the copies
+
+        Node node = &arena[i];
+
+        if (node->left != NULL)
+            node->left = node->left->hi;
+
+        if (node->right != NULL)
+            node->right = node->right->hi;
+
+        if (node->lo != NULL)
+            node->lo = node->lo->hi;
+
+        if (node->hi != NULL)
+            node->hi = node->hi->hi;
+
+    }
+
+    if (trie->jump != NULL)  // jump slots hold nodes too
+        for (size_t i = 0; i < ((size_t) 1 << JUMPBITS); i++)
+            trie->jump[i] = trie->jump[i]->hi;
+
+    Node root = trie->root->hi;
+
+    ibt_free_nodes(trie->root);
+
+    if (trie->arena != NULL)
+        arn_destroy(trie->arena);
+
+    trie->root = root;
+    trie->arena = storage;
+
+    return hot;
+
+}
+
+
+
+/// Moves future node and entry allocations into an Arena.
+
+char ibt_use_arena(Trie trie, int flags) {
+
+    if (trie->root != NULL || trie->pool != NULL)  // must start empty
+        return 0;
+
+    trie->pool = arn_create(flags);
+
+    if (trie->pool == NULL)  // signifies an allocation failure
+        return 0;
+
+    trie->pool_flags = flags;
+
+    return 1;
+
+}
+
+
+
+/// Fetches the node and entry storage mapped by the trie's arenas.
+
+size_t ibt_arena_mapped(Trie trie, size_t * huge) {
+
+    size_t mapped = 0;
+    *huge = 0;
+
+    if (trie->pool != NULL) {
+
+        mapped += arn_mapped(trie->pool);
+        *huge += arn_huge(trie->pool);
+
+    }
+
+    if (trie->arena != NULL) {
+
+        mapped += arn_mapped(trie->arena);
+        *huge += arn_huge(trie->arena);
+
+    }
+
+    return mapped;
+
+}
+
+
+
+/// Fetches the trie size.
+
+size_t ibt_size(Trie trie) {
+
+    return trie->leaf_nodes;
+
+}
+
+
+
+/// Calculates the number of internal trie nodes.
+
+size_t ibt_node_count(Trie trie) {
+
+    return trie->num_nodes - trie->leaf_nodes;
+
+}
+
+
+
+/// Fetches the trie height.
+
+size_t ibt_height(Trie trie) {
+
+    return trie->height;
+
+}
+
+
+
+/// Acts as a wrapper for user-passed display function to print an entry.
+
+void ibt_show_value(Trie trie, Entry entry, FILE * stream) {
+
+    if (trie->ibt_show_value_w == NULL) {  // handles incorrect ADT usage error
+
+        fprintf(stderr, "error: no user display function defined\n");
+        return;
+
+    }
+    // if user does not pass a display function pointer on creation an error
+    // message displays; the program will still continue to run, though
+
+    trie->ibt_show_value_w(entry, stream);
+    // cals user-defined display function
+
+}
+
+
+
+/// Displays trie data by walking the leaf list in key order.
+
+void ibt_show(Trie trie, FILE * stream) {
+
+    if (trie->root == NULL)  // nothing to display
+        return;
 
-    ibt_show_rec(trie, trie->root, stream);
+    for (Node leaf = ibt_leftmost(trie->root); leaf != NULL; leaf = leaf->hi)
+        ibt_show_value(trie, leaf->entry, stream);
 
 }
\ No newline at end of file
@@ -14,6 +14,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "arena.h"
+
 
 
 /// Public unsigned, integer key type for entries in the trie.
@@ -47,12 +49,29 @@ typedef struct Trie_s * Trie;
 
 
 
+/// Cursor over trie entries in key order.
+/// The node field is private to the trie module; use ibt_iter_seek to
+/// position the cursor and ibt_iter_next to advance it.
+struct Iter_s {
+
+    struct Node_s * node;
+
+};
+
+
+
+/// Defines Iter as the (stack allocatable) iterator struct.
+typedef struct Iter_s Iter;
+
+
+
 // constant values for bit processing available to application
 
 extern const size_t BITSPERBYTE;        /// < number of bits in a byte
 extern const size_t BITSPERWORD;        /// < number of bits in a word
 extern const size_t BYTESPERWORD;       /// < number of bytes in a word
 extern const size_t RADIX;              /// < number of possible byte values
+extern const size_t JUMPBITS;           /// < key bits indexing the jump table
 
 
 
@@ -89,6 +108,8 @@ void ibt_destroy(Trie trie);
 
 
 /// Insert an entry into the Trie as long as the entry is not already present.
+/// Keeps each subtree's extremal leaves and the key-ordered leaf links
+/// current, so that miss fallbacks and neighbor lookups are O(1).
 ///
 /// @param trie - a pointer to a Trie instance
 /// @param key - the unique key ID associated with each trie leaf node
@@ -112,6 +133,185 @@ Entry ibt_search(Trie trie, ikey_t key);
 
 
 
+/// Find the entry with the greatest key less than or equal to key.
+/// Costs one descent plus a single leaf link hop.
+///
+/// @param trie - a pointer to a Trie instance
+/// @param key - the key to find the predecessor of
+///
+/// @return the predecessor entry or NULL if none exists
+
+Entry ibt_predecessor(Trie trie, ikey_t key);
+
+
+
+/// Find the entry with the smallest key greater than or equal to key.
+/// Costs one descent plus a single leaf link hop.
+///
+/// @param trie - a pointer to a Trie instance
+/// @param key - the key to find the successor of
+///
+/// @return the successor entry or NULL if none exists
+
+Entry ibt_successor(Trie trie, ikey_t key);
+
+
+
+/// Position an iterator at the first entry with a key not below key.
+///
+/// @param trie - a pointer to a Trie instance
+/// @param iter - the iterator to position
+/// @param key - the key to seek to
+///
+/// @return the entry at the new position or NULL if past the last entry
+
+Entry ibt_iter_seek(Trie trie, Iter * iter, ikey_t key);
+
+
+
+/// Advance an iterator to the next entry in key order.
+///
+/// @param iter - an iterator positioned by ibt_iter_seek
+///
+/// @return the entry at the new position or NULL if past the last entry
+
+Entry ibt_iter_next(Iter * iter);
+
+
+
+/// Visit every entry with a key in [lo, hi] in key order.
+/// Costs one descent plus one step per entry visited.
+///
+/// @param trie - a pointer to a Trie instance
+/// @param lo - the lowest key to visit
+/// @param hi - the highest key to visit
+/// @param visit - function called for each entry in the range
+/// @param context - user pointer passed through to visit
+///
+/// @return the number of entries visited
+
+size_t ibt_range(Trie trie, ikey_t lo, ikey_t hi,
+    void (*visit)(Entry entry, void * context), void * context);
+
+
+
+/// Count the entries with keys strictly less than key.
+/// Runs in O(height) using the entry counts kept in internal nodes.
+///
+/// @param trie - a pointer to a Trie instance
+/// @param key - the key to rank
+///
+/// @return the number of entries preceding key
+
+size_t ibt_rank(Trie trie, ikey_t key);
+
+
+
+/// Get the entry at a zero-based position in key order.
+/// Runs in O(height), so ibt_select(trie, rand() % ibt_size(trie)) draws
+/// a uniform random entry without a full traversal.
+///
+/// @param trie - a pointer to a Trie instance
+/// @param index - the position of the entry
+///
+/// @return the entry at index or NULL if index >= ibt_size(trie)
+
+Entry ibt_select(Trie trie, size_t index);
+
+
+
+/// Leaf-push the trie: every internal node is given both children, with each
+/// added leaf holding the closest-match answer for its key interval.
+/// Searches then become a fixed walk from root to leaf with no fallback.
+/// A later ibt_insert undoes the pushing, so call this once loading is done.
+///
+/// @param trie - a pointer to a Trie instance
+///
+/// @post every descent in the trie ends at a leaf holding its answer
+
+void ibt_leaf_push(Trie trie);
+
+
+
+/// Build a 2^JUMPBITS-slot table indexed by the top JUMPBITS key bits.
+/// A slot points at the node JUMPBITS levels down where searches for its
+/// keys continue, or, when every key of the slot has the same closest
+/// match (a leaf or a missing branch above that depth), at the answer
+/// itself. A later ibt_insert drops the table, so call this once loading
+/// (and any ibt_leaf_push) is done.
+///
+/// @param trie - a pointer to a Trie instance
+///
+/// @return 1 if the table was built, 0 if the trie is empty or on failure
+
+char ibt_jump_build(Trie trie);
+
+
+
+/// Get the number of jump table slots answered without a trie walk.
+///
+/// @param trie - a pointer to a Trie instance
+///
+/// @return the count of direct slots (0 without a jump table)
+
+size_t ibt_jump_direct(Trie trie);
+
+
+
+/// Sample searches for hotness: every period-th ibt_search also credits
+/// each node on its path with a hit. The counts live in a table keyed by
+/// node that exists only while sampling (nodes carry no counter); a period
+/// of 0 stops sampling and frees it. If the table cannot be allocated,
+/// sampling stays off.
+///
+/// @param trie - a pointer to a Trie instance
+/// @param period - searches per sample
+
+void ibt_profile(Trie trie, size_t period);
+
+
+
+/// Move every node into one contiguous arena: nodes hit by sampled
+/// searches first, in depth-first order taking the hotter child first so
+/// hot root-to-leaf paths share cache lines and pages, then the cold
+/// nodes. Hit counts are halved, so calling this periodically while
+/// sampling keeps the layout following the traffic. Entries are not
+/// moved, so Entry pointers stay valid; iterators do not.
+///
+/// @param trie - a pointer to a Trie instance
+///
+/// @return the number of hot nodes packed (0 if empty or on failure,
+///     leaving the trie unchanged)
+
+size_t ibt_relayout(Trie trie);
+
+
+
+/// Allocate all later nodes and entries from an Arena of 2 MB chunks
+/// instead of one malloc each, so a large trie spans few TLB entries.
+/// The storage is only released by ibt_destroy; ibt_relayout also places
+/// its node arena in chunks with the same flags.
+///
+/// @param trie - a pointer to an empty Trie instance
+/// @param flags - ARN_HUGETLB, ARN_POPULATE and ARN_LOCK, or-ed together
+///
+/// @return 1 on success, 0 if the trie is not empty or on failure
+
+char ibt_use_arena(Trie trie, int flags);
+
+
+
+/// Get the node and entry storage mapped by the trie's arenas.
+///
+/// @param trie - a pointer to a Trie instance
+/// @param huge - bytes of it on reserved huge pages (passed as pointer)
+///
+/// @return total bytes mapped (0 when every node came from malloc)
+
+size_t ibt_arena_mapped(Trie trie, size_t * huge);
+
+
+
 /// Get the size of the trie or number of leaf elements.
 ///
 /// @param trie - a pointer to a Trie instance
@@ -152,7 +352,7 @@ void ibt_show_value(Trie trie, Entry entry, FILE * stream);
 
 
 
-/// Perform an in-order traversal to show each (key, value) in the trie.
+/// Walk the key-ordered leaf list to show each (key, value) in the trie.
 /// Uses Trie's show_value function to show each leaf node's data,
 /// and if the function is NULL, output each key and value in hexadecimal.
 ///
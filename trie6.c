@@ -0,0 +1,213 @@
+// File: trie6.c
+//
+// Description: module for a 128-bit keyed, path-compressed trie ADT
+//
+// A plain bit trie over 128-bit keys would be up to 128 levels deep, so
+// this is a crit-bit trie: each internal node stores the index of the bit
+// it tests and single-child chains are skipped entirely. The trie itself
+// is the IBT_DEFINE_KEYED engine of trie_define.h instantiated over the
+// two-word key type, with entries stored inline as its values. Searches
+// keep the closest-match semantics of the 32-bit trie.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "trie6.h"
+#include "trie_define.h"
+
+
+
+#define KEY_BIT(k, i) ((size_t) ((i) < 64 ? ((k).hi >> (63 - (i))) & 1 : \
+    ((k).lo >> (127 - (i))) & 1))
+// bit i of key k, counted from the most significant bit
+
+#define KEY_EQ(a, b) ((a).hi == (b).hi && (a).lo == (b).lo)
+// key equality
+
+#define KEY_LT(a, b) ((a).hi < (b).hi || ((a).hi == (b).hi && (a).lo < (b).lo))
+// key ordering
+
+
+
+IBT_DEFINE_KEYED(leaves6, ikey6_t, struct Entry6_s, KEY_BIT, KEY_EQ, KEY_LT)
+// crit-bit engine holding each entry inline, parallel to its key
+
+
+
+/// Defines the struct for the Trie6 ADT
+struct Trie6_s {
+
+    leaves6_t leaves;
+    // keys, entries and internal nodes
+
+    void (*ibt6_show_value_w)(Entry6 entry, FILE * stream);
+    // pointer to user-passed "show value" function
+
+    void (*ibt6_delete_entry)(Entry6 entry);
+    // pointer to user-passed entry deletion function
+
+};
+
+
+
+const size_t BITSPERKEY6 = 128;      /// < number of bits in a 128-bit key
+
+
+
+/// Creates and returns the initial Trie6 instance.
+
+Trie6 ibt6_create(void (*ext_show_value)(Entry6 entry, FILE * stream),
+    void (*ext_delete_entry)(Entry6 entry)) {
+
+    Trie6 trie = (Trie6) malloc(sizeof(struct Trie6_s));
+
+    if (trie == NULL)  // signifies an allocation failure
+        return NULL;
+
+    leaves6_init(&trie->leaves);
+    // sets initial values
+
+    trie->ibt6_show_value_w = ext_show_value;
+    trie->ibt6_delete_entry = ext_delete_entry;
+    // assigns user-passed functions
+
+    return trie;
+
+}
+
+
+
+/// Frees all dynamically allocates memory used in the Trie6 instance.
+
+void ibt6_destroy(Trie6 trie) {
+
+    if (trie->ibt6_delete_entry != NULL)  // calls user entry free function
+        for (size_t i = 0; i < trie->leaves.leaf_nodes; i++)
+            trie->ibt6_delete_entry(&trie->leaves.values[i]);
+
+    leaves6_destroy(&trie->leaves);
+    free(trie);
+
+}
+
+
+
+/// Inserts a new leaf into the Trie6 instance.
+
+void ibt6_insert(Trie6 trie, ikey6_t key, ival_t value) {
+
+    struct Entry6_s entry;
+    entry.key = key;
+    entry.value = value;
+
+    if (leaves6_insert(&trie->leaves, key, entry) < 0) {  // memory error
+
+        fprintf(stderr, "error: failed to allocate memory for trie node\n");
+        exit(EXIT_FAILURE);
+
+    }
+
+}
+
+
+
+/// Searches a Trie6 instance to find the closest match to a key.
+
+Entry6 ibt6_search(Trie6 trie, ikey6_t key) {
+
+    if (trie->leaves.leaf_nodes == 0) {  // handles unexpected empty trie error
+
+        fprintf(stderr, "error: cannot query an empty trie\n");
+        ibt6_destroy(trie);
+
+        exit(EXIT_FAILURE);
+
+    }
+
+    return &trie->leaves.values[leaves6_find(&trie->leaves, key)];
+
+}
+
+
+
+/// Fetches the trie size.
+
+size_t ibt6_size(Trie6 trie) {
+
+    return leaves6_size(&trie->leaves);
+
+}
+
+
+
+/// Calculates the number of internal trie nodes.
+
+size_t ibt6_node_count(Trie6 trie) {
+
+    return leaves6_node_count(&trie->leaves);
+
+}
+
+
+
+/// Computes the trie height.
+
+size_t ibt6_height(Trie6 trie) {
+
+    return leaves6_height(&trie->leaves);
+
+}
+
+
+
+/// Acts as a wrapper for user-passed display function to print an entry.
+
+void ibt6_show_value(Trie6 trie, Entry6 entry, FILE * stream) {
+
+    if (trie->ibt6_show_value_w == NULL) {  // handles incorrect ADT usage error
+
+        fprintf(stderr, "error: no user display function defined\n");
+        return;
+
+    }
+
+    trie->ibt6_show_value_w(entry, stream);
+
+}
+
+
+
+/// Recursively displays the elements of the Trie6 instance.
+///
+/// @param trie - the Trie6 instance to display
+/// @param cur - current node or tagged leaf index being recursed upon
+/// @param stream - the stream where display is output
+
+static void ibt6_show_rec(Trie6 trie, unsigned int cur, FILE * stream) {
+
+    if (cur & IBT_LEAF_TAG) {  // shows leaf values
+
+        ibt6_show_value(trie, &trie->leaves.values[cur & ~IBT_LEAF_TAG],
+            stream);
+        return;
+
+    }
+
+    ibt6_show_rec(trie, trie->leaves.nodes[cur].child[0], stream);
+    ibt6_show_rec(trie, trie->leaves.nodes[cur].child[1], stream);
+
+}
+
+
+
+/// Displays trie data.
+
+void ibt6_show(Trie6 trie, FILE * stream) {
+
+    if (trie->leaves.leaf_nodes != 0)
+        ibt6_show_rec(trie, trie->leaves.root, stream);
+
+}
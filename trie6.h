@@ -0,0 +1,155 @@
+// File: trie6.h
+//
+// Description: header for 128-bit keyed (IPv6) path-compressed trie ADT
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef TRIE6_H
+#define TRIE6_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+
+
+
+/// Public unsigned, 128-bit key type for entries in the trie.
+/// Stored as two 64-bit halves so no compiler extension is needed.
+typedef struct {
+
+    unsigned long long hi;
+    unsigned long long lo;
+
+} ikey6_t;
+
+
+
+/// Defines a single trie entry with a unique 128-bit key and place value.
+struct Entry6_s {
+
+    ival_t value;
+    ikey6_t key;
+
+};
+
+
+
+/// Defines Entry6 as a pointer to the entry struct.
+typedef struct Entry6_s * Entry6;
+
+
+
+/// Trie6 is a pointer to the Trie6 ADT.
+typedef struct Trie6_s * Trie6;
+
+
+
+extern const size_t BITSPERKEY6;        /// < number of bits in a 128-bit key
+
+
+
+/// Create a Trie6 instance and initialize its fields.
+///
+/// @param ext_show_value - a function pointer that the user passes
+///     to indicate how to display entry key and values properly
+/// @param ext_delete_entry - a function pointer that the user passes
+///     to indicate how values within a trie entry are freed
+///
+/// @return pointer to the Trie6 object instance or NULL on failure
+
+Trie6 ibt6_create(void (*ext_show_value)(Entry6 entry, FILE * stream),
+    void (*ext_delete_entry)(Entry6 entry));
+
+
+
+/// Destroy the trie and free all storage.
+///
+/// @param trie - a pointer to a Trie6 instance
+///
+/// @pre trie is a valid Trie6 instance pointer
+/// @post the storage associated with the Trie6 and all data has been freed
+
+void ibt6_destroy(Trie6 trie);
+
+
+
+/// Insert an entry into the Trie6 as long as the entry is not already present.
+///
+/// @param trie - a pointer to a Trie6 instance
+/// @param key - the unique key ID associated with each trie leaf node
+/// @param value - the value entry associated with the leaf node
+///
+/// @post the trie has grown to include a new entry IFF not already present
+
+void ibt6_insert(Trie6 trie, ikey6_t key, ival_t value);
+
+
+
+/// Search for the key in the trie by finding the closest entry that
+/// matches key, with the same closest-match semantics as ibt_search.
+///
+/// @param trie - a pointer to a Trie6 instance
+/// @param key - the key to find
+///
+/// @return entry representing the found entry or a null entry for not found;
+///     entries are stored inline, so it is valid until the next insert
+
+Entry6 ibt6_search(Trie6 trie, ikey6_t key);
+
+
+
+/// Get the size of the trie or number of leaf elements.
+///
+/// @param trie - a pointer to a Trie6 instance
+///
+/// @return size of trie
+
+size_t ibt6_size(Trie6 trie);
+
+
+
+/// Get the node count of the trie: the number of internal nodes.
+///
+/// @param trie - a pointer to a Trie6 instance
+///
+/// @return the count of internal nodes
+
+size_t ibt6_node_count(Trie6 trie);
+
+
+
+/// Get height of the trie (computed with a traversal).
+///
+/// @param trie - a pointer to a Trie6 instance
+///
+/// @return height of trie
+
+size_t ibt6_height(Trie6 trie);
+
+
+
+/// Displays an individual value in a the node.
+///
+/// @param trie - a pointer to a Trie6 instance
+/// @param entry - structure to hold node data
+/// @param stream - file stream to display data
+
+void ibt6_show_value(Trie6 trie, Entry6 entry, FILE * stream);
+
+
+
+/// Perform an in-order traversal to show each (key, value) in the trie.
+///
+/// @param trie - a pointer to a Trie6 instance
+/// @param stream - the stream destination of output
+
+void ibt6_show(Trie6 trie, FILE * stream);
+
+
+
+#endif  // TRIE6_H
@@ -0,0 +1,410 @@
+// File: trie_define.h
+//
+// Description: macro-generated tries specialized for a key and value type
+//
+// IBT_DEFINE(name, key_type, value_type) expands to a path-compressed
+// (crit-bit) trie whose values, such as 32-bit record IDs, are stored
+// inline rather than through ival_t pointers and user callbacks.
+// Searches keep the closest-match semantics of ibt_search. Unsigned
+// integer key types of any width are supported; other key types, such as
+// the two-word 128-bit keys of trie6.c, use IBT_DEFINE_KEYED and supply
+// their own bit test, equality and ordering macros.
+//
+// Storage is a structure of arrays: leaves are indices into a dense
+// keys[] array and a parallel values[] array, and internal nodes live in
+// their own array and refer to children by index. A descent reads only
+// node and key cache lines and touches values[] once for the answer, and
+// destruction frees three arrays with no traversal. Indices are 32-bit
+// with one tag bit, so a trie holds fewer than 2^31 leaves.
+//
+// Leaves inserted in ascending key order stay in key order; otherwise
+// name_freeze renumbers them so keys[] is sorted. Range scans then find
+// their start by binary search and their end by a scan, both over keys[]
+// alone, and read the matching keys and values as contiguous slices.
+//
+// Generated interface, for IBT_DEFINE(rid, ikey_t, unsigned int):
+//
+//     rid_t                           the trie type (declare by value)
+//     void rid_init(rid_t * trie)
+//     void rid_destroy(rid_t * trie)
+//     int rid_insert(rid_t * trie, ikey_t key, unsigned int value)
+//         returns 1 if inserted, 0 if key was present, -1 if memory ran
+//         out (the trie is left unchanged)
+//     int rid_search(rid_t * trie, ikey_t key, unsigned int * value)
+//         returns 0 on an empty trie, else 1 with the closest match's value
+//     unsigned int rid_find(rid_t * trie, ikey_t key)
+//         index into keys[] and values[] of the closest match (non-empty)
+//     int rid_freeze(rid_t * trie)
+//         puts keys[] and values[] in key order; 0 if memory ran out
+//     size_t rid_range(rid_t * trie, ikey_t lo, ikey_t hi, size_t * first)
+//         count of keys in [lo, hi], which are keys[*first] onward;
+//         freezes the trie first if needed (0 if that runs out of memory)
+//     size_t rid_size(rid_t * trie)
+//     size_t rid_node_count(rid_t * trie)
+//     size_t rid_height(rid_t * trie)
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef TRIE_DEFINE_H
+#define TRIE_DEFINE_H
+
+#include <stdlib.h>
+#include <limits.h>
+
+
+
+/// Bit i (counted from the most significant bit) of an unsigned key.
+#define IBT_KEY_BIT(key, i) \
+    ((size_t) (((key) >> (sizeof(key) * CHAR_BIT - 1 - (i))) & 1))
+
+
+
+/// Equality of two unsigned keys.
+#define IBT_KEY_EQ(a, b) ((a) == (b))
+
+
+
+/// Ordering of two unsigned keys.
+#define IBT_KEY_LT(a, b) ((a) < (b))
+
+
+
+/// Tags a child index as a leaf (index into keys[] and values[]) rather
+/// than an internal node (index into nodes[]).
+#define IBT_LEAF_TAG (1u << 31)
+
+
+
+/// Defines a specialized trie named name over unsigned integer key_type
+/// keys and inline value_type values.
+#define IBT_DEFINE(name, key_type, value_type)                               \
+    IBT_DEFINE_KEYED(name, key_type, value_type, IBT_KEY_BIT, IBT_KEY_EQ,    \
+        IBT_KEY_LT)
+
+
+
+/// Defines a specialized trie named name over key_type keys and inline
+/// value_type values. The trie touches keys only through key_bit(key, i),
+/// bit i of key counted from the most significant bit, key_eq(a, b) and
+/// key_lt(a, b), true if a orders before b.
+#define IBT_DEFINE_KEYED(name, key_type, value_type, key_bit, key_eq,        \
+    key_lt)                                                                  \
+                                                                             \
+struct name##_node_s {                                                       \
+                                                                             \
+    unsigned int child[2];   /* node index, or leaf index | IBT_LEAF_TAG */  \
+    unsigned int bit;        /* crit bit tested by this node */              \
+                                                                             \
+};                                                                           \
+                                                                             \
+typedef struct {                                                             \
+                                                                             \
+    key_type * keys;                   /* leaf keys */                       \
+    value_type * values;               /* leaf values, parallel to keys */   \
+    size_t leaf_nodes;                                                       \
+    size_t leaf_cap;                                                         \
+    int sorted;                        /* keys[] is in key order */          \
+                                                                             \
+    struct name##_node_s * nodes;      /* internal nodes */                  \
+    size_t num_nodes;                                                        \
+    size_t node_cap;                                                         \
+                                                                             \
+    unsigned int root;                                                       \
+                                                                             \
+} name##_t;                                                                  \
+                                                                             \
+static inline void name##_init(name##_t * trie) {                            \
+                                                                             \
+    trie->keys = NULL;                                                       \
+    trie->values = NULL;                                                     \
+    trie->leaf_nodes = 0;                                                    \
+    trie->leaf_cap = 0;                                                      \
+    trie->sorted = 1;                                                        \
+    trie->nodes = NULL;                                                      \
+    trie->num_nodes = 0;                                                     \
+    trie->node_cap = 0;                                                      \
+    trie->root = IBT_LEAF_TAG;                                               \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline void name##_destroy(name##_t * trie) {                         \
+                                                                             \
+    free(trie->keys);                                                        \
+    free(trie->values);                                                      \
+    free(trie->nodes);                                                       \
+    name##_init(trie);                                                       \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline unsigned int name##_descend(name##_t * trie, key_type key) {   \
+                                                                             \
+    unsigned int cur = trie->root;                                           \
+                                                                             \
+    while (!(cur & IBT_LEAF_TAG))                                            \
+        cur = trie->nodes[cur].child[key_bit(key, trie->nodes[cur].bit)];    \
+                                                                             \
+    return cur & ~IBT_LEAF_TAG;                                              \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline size_t name##_crit_bit(key_type a, key_type b) {               \
+                                                                             \
+    size_t bit = 0;                                                          \
+                                                                             \
+    while (key_bit(a, bit) == key_bit(b, bit))                               \
+        bit++;                                                               \
+                                                                             \
+    return bit;                                                              \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline int name##_insert(name##_t * trie, key_type key,               \
+    value_type value) {                                                      \
+                                                                             \
+    size_t bit = 0;                                                          \
+                                                                             \
+    if (trie->leaf_nodes != 0) {  /* finds the crit bit to split at */       \
+                                                                             \
+        key_type closest = trie->keys[name##_descend(trie, key)];            \
+                                                                             \
+        if (key_eq(closest, key))                                            \
+            return 0;                                                        \
+                                                                             \
+        bit = name##_crit_bit(key, closest);                                 \
+                                                                             \
+    }                                                                        \
+                                                                             \
+    if (trie->leaf_nodes == trie->leaf_cap) {  /* grows leaf arrays */       \
+                                                                             \
+        size_t cap = (trie->leaf_cap == 0) ? 16 : trie->leaf_cap * 2;        \
+        key_type * keys = (key_type *) realloc(trie->keys,                   \
+            cap * sizeof(key_type));                                         \
+                                                                             \
+        if (keys == NULL)  /* handles memory error, trie unchanged */        \
+            return -1;                                                       \
+                                                                             \
+        trie->keys = keys;                                                   \
+        value_type * values = (value_type *) realloc(trie->values,           \
+            cap * sizeof(value_type));                                       \
+                                                                             \
+        if (values == NULL)                                                  \
+            return -1;                                                       \
+                                                                             \
+        trie->values = values;                                               \
+        trie->leaf_cap = cap;                                                \
+                                                                             \
+    }                                                                        \
+                                                                             \
+    /* grows node array; the first leaf needs no node */                     \
+    if (trie->leaf_nodes != 0 && trie->num_nodes == trie->node_cap) {        \
+                                                                             \
+        size_t cap = (trie->node_cap == 0) ? 16 : trie->node_cap * 2;        \
+        struct name##_node_s * nodes = (struct name##_node_s *) realloc(     \
+            trie->nodes, cap * sizeof(struct name##_node_s));                \
+                                                                             \
+        if (nodes == NULL)  /* handles memory error, trie unchanged */       \
+            return -1;                                                       \
+                                                                             \
+        trie->nodes = nodes;                                                 \
+        trie->node_cap = cap;                                                \
+                                                                             \
+    }                                                                        \
+                                                                             \
+    if (trie->leaf_nodes != 0 &&                                             \
+        !key_lt(trie->keys[trie->leaf_nodes - 1], key))                      \
+        trie->sorted = 0;                                                    \
+    /* appending in ascending key order keeps the leaves sorted */           \
+                                                                             \
+    unsigned int leaf = (unsigned int) trie->leaf_nodes++;                   \
+    trie->keys[leaf] = key;                                                  \
+    trie->values[leaf] = value;                                              \
+                                                                             \
+    if (leaf == 0) {  /* handles empty tree case */                          \
+                                                                             \
+        trie->root = IBT_LEAF_TAG;                                           \
+        return 1;                                                            \
+                                                                             \
+    }                                                                        \
+                                                                             \
+    unsigned int * slot = &trie->root;                                       \
+                                                                             \
+    while (!(*slot & IBT_LEAF_TAG) && trie->nodes[*slot].bit < bit)          \
+        slot = &trie->nodes[*slot].child[                                    \
+            key_bit(key, trie->nodes[*slot].bit)];                           \
+                                                                             \
+    unsigned int branch = (unsigned int) trie->num_nodes++;                  \
+    trie->nodes[branch].bit = (unsigned int) bit;                            \
+    trie->nodes[branch].child[key_bit(key, bit)] = leaf | IBT_LEAF_TAG;      \
+    trie->nodes[branch].child[!key_bit(key, bit)] = *slot;                   \
+    *slot = branch;                                                          \
+                                                                             \
+    return 1;                                                                \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline unsigned int name##_find(name##_t * trie, key_type key) {      \
+                                                                             \
+    unsigned int leaf = name##_descend(trie, key);                           \
+                                                                             \
+    if (!key_eq(trie->keys[leaf], key)) {  /* falls back to nearest leaf */  \
+                                                                             \
+        size_t bit = name##_crit_bit(key, trie->keys[leaf]);                 \
+        size_t side = key_bit(key, bit);                                     \
+        unsigned int cur = trie->root;                                       \
+                                                                             \
+        while (!(cur & IBT_LEAF_TAG) && trie->nodes[cur].bit < bit)          \
+            cur = trie->nodes[cur].child[                                    \
+                key_bit(key, trie->nodes[cur].bit)];                         \
+                                                                             \
+        while (!(cur & IBT_LEAF_TAG))                                        \
+            cur = trie->nodes[cur].child[side];                              \
+                                                                             \
+        leaf = cur & ~IBT_LEAF_TAG;                                          \
+                                                                             \
+    }                                                                        \
+                                                                             \
+    return leaf;                                                             \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline int name##_search(name##_t * trie, key_type key,               \
+    value_type * value) {                                                    \
+                                                                             \
+    if (trie->leaf_nodes == 0)                                               \
+        return 0;                                                            \
+                                                                             \
+    *value = trie->values[name##_find(trie, key)];                           \
+                                                                             \
+    return 1;                                                                \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline void name##_freeze_rec(name##_t * trie, unsigned int * slot,   \
+    key_type * keys, value_type * values, size_t * next) {                   \
+                                                                             \
+    if (*slot & IBT_LEAF_TAG) {  /* renumbers the leaf to its rank */        \
+                                                                             \
+        keys[*next] = trie->keys[*slot & ~IBT_LEAF_TAG];                     \
+        values[*next] = trie->values[*slot & ~IBT_LEAF_TAG];                 \
+        *slot = (unsigned int) (*next)++ | IBT_LEAF_TAG;                     \
+                                                                             \
+        return;                                                              \
+                                                                             \
+    }                                                                        \
+                                                                             \
+    name##_freeze_rec(trie, &trie->nodes[*slot].child[0], keys, values,      \
+        next);                                                               \
+    name##_freeze_rec(trie, &trie->nodes[*slot].child[1], keys, values,      \
+        next);                                                               \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline int name##_freeze(name##_t * trie) {                           \
+                                                                             \
+    if (trie->sorted)                                                        \
+        return 1;                                                            \
+                                                                             \
+    key_type * keys = (key_type *) malloc(                                   \
+        trie->leaf_nodes * sizeof(key_type));                                \
+    value_type * values = (value_type *) malloc(                             \
+        trie->leaf_nodes * sizeof(value_type));                              \
+                                                                             \
+    if (keys == NULL || values == NULL) {  /* handles memory error */        \
+                                                                             \
+        free(keys);                                                          \
+        free(values);                                                        \
+                                                                             \
+        return 0;                                                            \
+                                                                             \
+    }                                                                        \
+                                                                             \
+    size_t next = 0;                                                         \
+    name##_freeze_rec(trie, &trie->root, keys, values, &next);               \
+    /* an in-order walk meets the leaves in key order */                     \
+                                                                             \
+    free(trie->keys);                                                        \
+    free(trie->values);                                                      \
+    trie->keys = keys;                                                       \
+    trie->values = values;                                                   \
+    trie->leaf_cap = trie->leaf_nodes;                                       \
+    trie->sorted = 1;                                                        \
+                                                                             \
+    return 1;                                                                \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline size_t name##_lower_bound(name##_t * trie, key_type key) {     \
+                                                                             \
+    size_t lo = 0;                                                           \
+    size_t hi = trie->leaf_nodes;                                            \
+                                                                             \
+    while (lo < hi) {  /* first key not ordered before key */                \
+                                                                             \
+        size_t mid = lo + (hi - lo) / 2;                                     \
+                                                                             \
+        if (key_lt(trie->keys[mid], key))                                    \
+            lo = mid + 1;                                                    \
+        else                                                                 \
+            hi = mid;                                                        \
+                                                                             \
+    }                                                                        \
+                                                                             \
+    return lo;                                                               \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline size_t name##_range(name##_t * trie, key_type lo,              \
+    key_type hi, size_t * first) {                                           \
+                                                                             \
+    *first = 0;                                                              \
+                                                                             \
+    if (key_lt(hi, lo) || !name##_freeze(trie))                              \
+        return 0;                                                            \
+                                                                             \
+    *first = name##_lower_bound(trie, lo);                                   \
+    size_t end = *first;                                                     \
+                                                                             \
+    while (end < trie->leaf_nodes && !key_lt(hi, trie->keys[end]))           \
+        end++;                                                               \
+                                                                             \
+    return end - *first;                                                     \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline size_t name##_size(name##_t * trie) {                          \
+                                                                             \
+    return trie->leaf_nodes;                                                 \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline size_t name##_node_count(name##_t * trie) {                    \
+                                                                             \
+    return trie->num_nodes;                                                  \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline size_t name##_height_rec(name##_t * trie, unsigned int cur) {  \
+                                                                             \
+    if (cur & IBT_LEAF_TAG)                                                  \
+        return 1;                                                            \
+                                                                             \
+    size_t left = name##_height_rec(trie, trie->nodes[cur].child[0]);        \
+    size_t right = name##_height_rec(trie, trie->nodes[cur].child[1]);       \
+                                                                             \
+    return 1 + ((left > right) ? left : right);                              \
+                                                                             \
+}                                                                            \
+                                                                             \
+static inline size_t name##_height(name##_t * trie) {                        \
+                                                                             \
+    return (trie->leaf_nodes == 0) ? 0 : name##_height_rec(trie, trie->root);\
+                                                                             \
+}
+
+
+
+#endif  // TRIE_DEFINE_H
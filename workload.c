@@ -0,0 +1,435 @@
+// File: workload.c
+//
+// Description: module for benchmark workloads: the range rows a trie is
+// loaded from, the query key streams it is measured with, and the clock
+// and memory readings the benchmark tools report
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#define _DEFAULT_SOURCE
+// exposes getline and clock_gettime
+
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "workload.h"
+
+
+
+/// Defines the struct for the Workload ADT
+struct Workload_s {
+
+    ikey_t * lo;
+    ikey_t * hi;
+    size_t rows;
+    size_t cap;
+    // row bounds, in file order
+
+};
+
+
+
+const char * WKL_STREAM_NAMES[] = { "uniform", "zipf", "sequential" };
+const size_t WKL_ZIPFRANKS = 1 << 20;
+
+
+
+/// Creates an empty workload.
+///
+/// @return pointer to the Workload instance or NULL on failure
+
+static Workload wkl_create(void) {
+
+    Workload work = (Workload) malloc(sizeof(struct Workload_s));
+
+    if (work == NULL)  // signifies an allocation failure
+        return NULL;
+
+    work->lo = NULL;
+    work->hi = NULL;
+    work->rows = 0;
+    work->cap = 0;
+
+    return work;
+
+}
+
+
+
+/// Appends a row, doubling the arrays when full.
+///
+/// @param work - the Workload instance
+/// @param lo - the lower bound
+/// @param hi - the upper bound
+///
+/// @return 1 on success, 0 on allocation failure
+
+static int wkl_add(Workload work, ikey_t lo, ikey_t hi) {
+
+    if (work->rows == work->cap) {  // grows row arrays
+
+        size_t cap = (work->cap == 0) ? 1024 : work->cap * 2;
+        ikey_t * nlo = (ikey_t *) realloc(work->lo, cap * sizeof(ikey_t));
+
+        if (nlo == NULL)  // handles allocation failure
+            return 0;
+
+        work->lo = nlo;
+
+        ikey_t * nhi = (ikey_t *) realloc(work->hi, cap * sizeof(ikey_t));
+
+        if (nhi == NULL)  // handles allocation failure
+            return 0;
+
+        work->hi = nhi;
+        work->cap = cap;
+
+    }
+
+    work->lo[work->rows] = lo;
+    work->hi[work->rows] = hi;
+    work->rows++;
+
+    return 1;
+
+}
+
+
+
+/// Reads the bounds of every CSV row.
+
+Workload wkl_read_csv(FILE * fp, size_t max_rows) {
+
+    Workload work = wkl_create();
+
+    if (work == NULL)  // signifies an allocation failure
+        return NULL;
+
+    char * buf = NULL;
+    size_t blen = 0;
+
+    while ((max_rows == 0 || work->rows < max_rows) &&
+        getline(&buf, &blen, fp) != -1) {  // reads one row per line
+
+        ikey_t lo;
+        ikey_t hi;
+
+        if (sscanf(buf, "\"%u\",\"%u\"", &lo, &hi) != 2)  // skips bad rows
+            continue;
+
+        if (!wkl_add(work, lo, hi)) {  // handles allocation failure
+
+            free(buf);
+            wkl_destroy(work);
+
+            return NULL;
+
+        }
+
+    }
+
+    free(buf);
+
+    return work;
+
+}
+
+
+
+/// Creates evenly spread synthetic rows.
+
+Workload wkl_synthetic(size_t rows, unsigned long long seed) {
+
+    Workload work = wkl_create();
+
+    if (work == NULL || rows == 0)  // signifies an allocation failure
+        return work;
+
+    unsigned long long share = (1ULL << BITSPERWORD) / rows;
+    unsigned long long state = seed;
+
+    if (share == 0)  // more rows than keys
+        share = 1;
+
+    for (size_t i = 0; i < rows && i * share < (1ULL << BITSPERWORD); i++) {
+
+        unsigned long long base = i * share;
+        unsigned long long lo = base + wkl_random(&state) % share;
+        unsigned long long hi = lo + wkl_random(&state) % (base + share - lo);
+
+        if (!wkl_add(work, (ikey_t) lo, (ikey_t) hi)) {  // allocation failure
+
+            wkl_destroy(work);
+            return NULL;
+
+        }
+
+    }
+    // each row stays inside its own share, so rows never overlap
+
+    return work;
+
+}
+
+
+
+/// Frees the workload.
+
+void wkl_destroy(Workload work) {
+
+    free(work->lo);
+    free(work->hi);
+    free(work);
+
+}
+
+
+
+/// Fetches the row count.
+
+size_t wkl_rows(Workload work) {
+
+    return work->rows;
+
+}
+
+
+
+/// Fetches a row's lower bound.
+
+ikey_t wkl_lo(Workload work, size_t row) {
+
+    return work->lo[row];
+
+}
+
+
+
+/// Fetches a row's upper bound.
+
+ikey_t wkl_hi(Workload work, size_t row) {
+
+    return work->hi[row];
+
+}
+
+
+
+/// Picks a random key inside a row.
+///
+/// @param work - the Workload instance
+/// @param row - the row index
+/// @param state - the generator state (passed as pointer)
+///
+/// @return a key between the row's bounds
+
+static ikey_t wkl_row_key(Workload work, size_t row,
+    unsigned long long * state) {
+
+    ikey_t lo = work->lo[row];
+    ikey_t hi = work->hi[row];
+
+    if (lo > hi) {  // tolerates rows written high bound first
+
+        ikey_t tmp = lo;
+        lo = hi;
+        hi = tmp;
+
+    }
+
+    return lo + (ikey_t) (wkl_random(state) %
+        ((unsigned long long) hi - lo + 1));
+
+}
+
+
+
+/// Fills an array with Zipf-skewed keys.
+///
+/// @param work - the Workload instance
+/// @param keys - the array to fill
+/// @param count - the number of keys
+/// @param s - the Zipf exponent
+/// @param state - the generator state (passed as pointer)
+///
+/// @return 1 on success, 0 on allocation failure
+
+static int wkl_zipf(Workload work, ikey_t * keys, size_t count, double s,
+    unsigned long long * state) {
+
+    size_t ranks = (work->rows < WKL_ZIPFRANKS) ? work->rows : WKL_ZIPFRANKS;
+
+    double * cdf = (double *) malloc(ranks * sizeof(double));
+    size_t * row = (size_t *) malloc(ranks * sizeof(size_t));
+
+    if (cdf == NULL || row == NULL) {  // handles allocation failure
+
+        free(cdf);
+        free(row);
+
+        return 0;
+
+    }
+
+    double total = 0;
+
+    for (size_t r = 0; r < ranks; r++) {  // ranks random rows by popularity
+
+        total += 1.0 / pow((double) (r + 1), s);
+        cdf[r] = total;
+        row[r] = (size_t) (wkl_random(state) % work->rows);
+
+    }
+
+    for (size_t i = 0; i < count; i++) {  // inverts the CDF by binary search
+
+        double u = (double) (wkl_random(state) >> 11) / (double) (1ULL << 53)
+            * total;
+
+        size_t lo = 0;
+        size_t hi = ranks - 1;
+
+        while (lo < hi) {
+
+            size_t mid = lo + (hi - lo) / 2;
+
+            if (cdf[mid] <= u)
+                lo = mid + 1;
+            else
+                hi = mid;
+
+        }
+
+        keys[i] = wkl_row_key(work, row[lo], state);
+
+    }
+
+    free(cdf);
+    free(row);
+
+    return 1;
+
+}
+
+
+
+/// Generates a query key stream.
+
+ikey_t * wkl_queries(Workload work, int kind, size_t count, double zipf_s,
+    unsigned long long seed) {
+
+    ikey_t * keys = (ikey_t *) malloc((count + 1) * sizeof(ikey_t));
+
+    if (keys == NULL)  // signifies an allocation failure
+        return NULL;
+
+    unsigned long long state = seed;
+
+    switch (kind) {
+
+        case WKL_UNIFORM:  // any key equally likely
+
+            for (size_t i = 0; i < count; i++)
+                keys[i] = (ikey_t) wkl_random(&state);
+
+            break;
+
+        case WKL_ZIPF:  // a few rows take most queries
+
+            if (!wkl_zipf(work, keys, count, zipf_s, &state)) {
+
+                free(keys);
+                return NULL;
+
+            }
+
+            break;
+
+        default:  // even steps from key 0 up to the top of the key space
+
+            for (size_t i = 0; i < count; i++)
+                keys[i] = (ikey_t) (((unsigned long long) i <<
+                    BITSPERWORD) / count);
+
+            break;
+
+    }
+
+    return keys;
+
+}
+
+
+
+/// Advances a splitmix64 generator.
+
+unsigned long long wkl_random(unsigned long long * state) {
+
+    unsigned long long z = (*state += 0x9e3779b97f4a7c15ULL);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+
+    return z ^ (z >> 31);
+
+}
+
+
+
+/// Reads the monotonic clock.
+
+unsigned long long wkl_now_ns(void) {
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (unsigned long long) ts.tv_sec * 1000000000ULL +
+        (unsigned long long) ts.tv_nsec;
+
+}
+
+
+
+/// Reads the resident page count from /proc.
+
+size_t wkl_rss(void) {
+
+    FILE * fp = fopen("/proc/self/statm", "r");
+
+    if (fp == NULL)  // not on Linux
+        return 0;
+
+    unsigned long size;
+    unsigned long resident;
+    int read = fscanf(fp, "%lu %lu", &size, &resident);
+
+    fclose(fp);
+
+    if (read != 2)  // unexpected format
+        return 0;
+
+    return (size_t) resident * (size_t) sysconf(_SC_PAGESIZE);
+
+}
+
+
+
+/// Reads the peak resident size from the kernel's usage counters.
+
+size_t wkl_max_rss(void) {
+
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)  // handles failure
+        return 0;
+
+    return (size_t) usage.ru_maxrss * 1024;
+    // reported in kilobytes on Linux
+
+}
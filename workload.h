@@ -0,0 +1,161 @@
+// File: workload.h
+//
+// Description: header for the benchmark workload module (range datasets,
+// query key streams, clock and memory readings)
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+
+
+
+/// Workload is a pointer to the Workload ADT.
+typedef struct Workload_s * Workload;
+
+
+
+#define WKL_UNIFORM 0
+// query keys drawn uniformly from the whole key space
+
+#define WKL_ZIPF 1
+// query keys falling in rows chosen with Zipf-skewed popularity
+
+#define WKL_SEQUENTIAL 2
+// query keys sweeping the key space in ascending order
+
+#define WKL_STREAMS 3
+// number of query stream kinds
+
+
+
+extern const char * WKL_STREAM_NAMES[];  /// < stream names, by kind
+extern const size_t WKL_ZIPFRANKS;       /// < most rows given a Zipf rank
+
+
+
+/// Read the bounds of every row of a place_ip CSV file (values are
+/// not kept).
+///
+/// @param fp - the open CSV file
+/// @param max_rows - the most rows to read, or 0 for all of them
+///
+/// @return pointer to the Workload instance or NULL on failure
+
+Workload wkl_read_csv(FILE * fp, size_t max_rows);
+
+
+
+/// Create rows of disjoint ranges spread evenly over the key space, each
+/// covering a random part of its share.
+///
+/// @param rows - the number of rows to create
+/// @param seed - the random seed
+///
+/// @return pointer to the Workload instance or NULL on failure
+
+Workload wkl_synthetic(size_t rows, unsigned long long seed);
+
+
+
+/// Destroy the workload.
+///
+/// @param work - a pointer to a Workload instance
+
+void wkl_destroy(Workload work);
+
+
+
+/// Get the number of rows in the workload.
+///
+/// @param work - a pointer to a Workload instance
+///
+/// @return the row count
+
+size_t wkl_rows(Workload work);
+
+
+
+/// Get the lower bound of a row.
+///
+/// @param work - a pointer to a Workload instance
+/// @param row - the row index
+///
+/// @return the lower bound
+
+ikey_t wkl_lo(Workload work, size_t row);
+
+
+
+/// Get the upper bound of a row.
+///
+/// @param work - a pointer to a Workload instance
+/// @param row - the row index
+///
+/// @return the upper bound
+
+ikey_t wkl_hi(Workload work, size_t row);
+
+
+
+/// Generate a stream of query keys. Zipf streams rank up to WKL_ZIPFRANKS
+/// randomly chosen rows, pick rank r with probability proportional to
+/// 1 / r^s and query a random key inside that row.
+///
+/// @param work - a pointer to a non-empty Workload instance
+/// @param kind - WKL_UNIFORM, WKL_ZIPF or WKL_SEQUENTIAL
+/// @param count - the number of keys to generate
+/// @param zipf_s - the Zipf exponent s (used by WKL_ZIPF only)
+/// @param seed - the random seed
+///
+/// @return an array of count keys (freed by the caller) or NULL on failure
+
+ikey_t * wkl_queries(Workload work, int kind, size_t count, double zipf_s,
+    unsigned long long seed);
+
+
+
+/// Advance a splitmix64 generator.
+///
+/// @param state - the generator state (passed as pointer)
+///
+/// @return the next 64 random bits
+
+unsigned long long wkl_random(unsigned long long * state);
+
+
+
+/// Read the monotonic clock.
+///
+/// @return nanoseconds since an arbitrary fixed point
+
+unsigned long long wkl_now_ns(void);
+
+
+
+/// Get the process's resident set size.
+///
+/// @return resident bytes, or 0 if unavailable
+
+size_t wkl_rss(void);
+
+
+
+/// Get the process's peak resident set size.
+///
+/// @return peak resident bytes, or 0 if unavailable
+
+size_t wkl_max_rss(void);
+
+
+
+#endif  // WORKLOAD_H
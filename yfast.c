@@ -0,0 +1,287 @@
+// File: yfast.c
+//
+// Description: module for a y-fast trie style predecessor index over the
+// range starts of a normalized Ranges table
+//
+// The sorted starts are cut into buckets of BITSPERWORD keys. The first
+// key of each bucket (its representative) is entered in an x-fast trie:
+// for every prefix length l there is a hash table of the l-bit prefixes
+// of the representatives, each holding the first and last representative
+// below it. Prefix presence is monotone in l, so the longest prefix of a
+// query that is present is found by binary search on l (Waldvogel style)
+// in about log2(33) probes. The next query bit then says whether the
+// predecessor representative is the last one below that prefix or the
+// one just before the first, and a binary search of that bucket finishes
+// the lookup.
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#include "yfast.h"
+
+
+
+#define EMPTY ((unsigned int) -1)
+// marks an unused hash slot
+
+
+
+/// Slot_s is one hash table slot: a prefix and the representatives below.
+struct Slot_s {
+
+    ikey_t prefix;
+    unsigned int first;
+    unsigned int last;
+
+};
+
+
+
+/// Level_s is the hash table for one prefix length.
+struct Level_s {
+
+    struct Slot_s * slots;
+    size_t mask;
+    // table size - 1 (size is a power of two)
+
+};
+
+
+
+/// Defines the struct for the YFast ADT
+struct YFast_s {
+
+    ikey_t * starts;
+    size_t count;
+    // every range start in key order (bucket i is starts[i * 32 ...])
+
+    size_t num_reps;
+    // number of buckets
+
+    struct Level_s levels[33];
+    // one table per prefix length 0 .. BITSPERWORD
+
+    Ranges ranges;
+
+};
+
+
+
+/// Gets the l-bit prefix of a key.
+///
+/// @param key - the key
+/// @param len - the prefix length
+///
+/// @return the prefix, right aligned
+
+static ikey_t yft_prefix(ikey_t key, size_t len) {
+
+    return (len == 0) ? 0 : key >> (BITSPERWORD - len);
+
+}
+
+
+
+/// Hashes a prefix into a table.
+///
+/// @param prefix - the prefix
+/// @param mask - the table mask
+///
+/// @return the first slot to probe
+
+static size_t yft_hash(ikey_t prefix, size_t mask) {
+
+    return ((prefix + 1) * 2654435761u) & mask;
+
+}
+
+
+
+/// Finds the slot of a prefix, or the empty slot where it belongs.
+///
+/// @param level - the prefix length's table
+/// @param prefix - the prefix
+///
+/// @return the slot
+
+static struct Slot_s * yft_probe(struct Level_s * level, ikey_t prefix) {
+
+    size_t i = yft_hash(prefix, level->mask);
+
+    while (level->slots[i].first != EMPTY &&
+        level->slots[i].prefix != prefix)  // linear probing
+        i = (i + 1) & level->mask;
+
+    return &level->slots[i];
+
+}
+
+
+
+/// Frees all storage used by the index.
+
+void yft_destroy(YFast index) {
+
+    for (size_t l = 0; l <= BITSPERWORD; l++)
+        free(index->levels[l].slots);
+
+    free(index->starts);
+    free(index);
+
+}
+
+
+
+/// Builds the index from normalized ranges.
+
+YFast yft_build(Ranges ranges) {
+
+    YFast index = (YFast) calloc(1, sizeof(struct YFast_s));
+
+    if (index == NULL)  // signifies an allocation failure
+        return NULL;
+
+    index->ranges = ranges;
+    index->count = rng_count(ranges);
+    index->num_reps = (index->count + BITSPERWORD - 1) / BITSPERWORD;
+    index->starts = (ikey_t *) malloc((index->count + 1) * sizeof(ikey_t));
+
+    if (index->starts == NULL) {  // allocation failure
+
+        yft_destroy(index);
+        return NULL;
+
+    }
+
+    for (size_t i = 0; i < index->count; i++)  // copies out range starts
+        index->starts[i] = rng_items(ranges)[i].lo;
+
+    size_t size = 2;
+
+    while (size < 2 * index->num_reps)  // keeps tables at most half full
+        size *= 2;
+
+    for (size_t l = 0; l <= BITSPERWORD; l++) {  // fills one table per length
+
+        struct Level_s * level = &index->levels[l];
+
+        level->mask = size - 1;
+        level->slots = (struct Slot_s *) malloc(size * sizeof(struct Slot_s));
+
+        if (level->slots == NULL) {  // allocation failure
+
+            yft_destroy(index);
+            return NULL;
+
+        }
+
+        for (size_t i = 0; i < size; i++)
+            level->slots[i].first = EMPTY;
+
+        for (size_t r = 0; r < index->num_reps; r++) {  // reps are ascending
+
+            ikey_t prefix = yft_prefix(index->starts[r * BITSPERWORD], l);
+            struct Slot_s * slot = yft_probe(level, prefix);
+
+            if (slot->first == EMPTY) {  // first representative below prefix
+
+                slot->prefix = prefix;
+                slot->first = (unsigned int) r;
+
+            }
+
+            slot->last = (unsigned int) r;
+
+        }
+
+    }
+
+    return index;
+
+}
+
+
+
+/// Finds the containing range through the predecessor representative.
+
+size_t yft_lookup(YFast index, ikey_t key) {
+
+    if (index->count == 0 || key < index->starts[0])  // no predecessor
+        return RNG_NONE;
+
+    size_t lo = 0;
+    size_t hi = BITSPERWORD;
+    struct Slot_s * best = yft_probe(&index->levels[0], 0);
+
+    while (lo < hi) {  // binary search for the longest present prefix
+
+        size_t mid = (lo + hi + 1) / 2;
+        struct Slot_s * slot = yft_probe(&index->levels[mid],
+            yft_prefix(key, mid));
+
+        if (slot->first != EMPTY) {
+
+            best = slot;
+            lo = mid;
+
+        } else {
+
+            hi = mid - 1;
+
+        }
+
+    }
+
+    size_t rep;
+
+    if (lo == BITSPERWORD) {  // key is itself a representative
+
+        rep = best->first;
+
+    } else if ((key >> (BITSPERWORD - 1 - lo)) & 1) {  // reps below are lower
+
+        rep = best->last;
+
+    } else {  // reps below are higher, so take the one before them
+
+        rep = best->first - 1;
+
+    }
+
+    size_t first = rep * BITSPERWORD;
+    size_t end = first + BITSPERWORD;
+
+    if (end > index->count)
+        end = index->count;
+
+    while (end - first > 1) {  // finds the last start not above key
+
+        size_t mid = first + (end - first) / 2;
+
+        if (index->starts[mid] <= key)
+            first = mid;
+        else
+            end = mid;
+
+    }
+
+    if (rng_items(index->ranges)[first].hi < key)  // key is in a gap
+        return RNG_NONE;
+
+    return first;
+
+}
+
+
+
+/// Computes the bytes used by the index.
+
+size_t yft_memory(YFast index) {
+
+    return index->count * sizeof(ikey_t) +
+        (BITSPERWORD + 1) * (index->levels[0].mask + 1) * sizeof(struct Slot_s);
+
+}
@@ -0,0 +1,70 @@
+// File: yfast.h
+//
+// Description: header for a y-fast trie style predecessor index over ranges
+//
+// @author Maximus Milazzo (mam9563@rit.edu)
+//
+///////////////////////////////////////////////////////////
+
+
+
+#ifndef YFAST_H
+#define YFAST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "trie.h"
+#include "ranges.h"
+
+
+
+/// YFast is a pointer to the YFast ADT.
+typedef struct YFast_s * YFast;
+
+
+
+/// Build a read-only y-fast index over the range starts.
+/// Starts are grouped into sorted buckets of BITSPERWORD keys, and the
+/// first key of each bucket is indexed by one hash table per prefix
+/// length, so a predecessor is found with a binary search over prefix
+/// lengths: O(log log U) = 5 probes, then one bucket search.
+///
+/// @param ranges - a pointer to a normalized Ranges instance
+///
+/// @return pointer to the YFast instance or NULL on failure
+
+YFast yft_build(Ranges ranges);
+
+
+
+/// Destroy the index and free all storage (the Ranges are not touched).
+///
+/// @param index - a pointer to a YFast instance
+
+void yft_destroy(YFast index);
+
+
+
+/// Find the range containing key from its predecessor range start.
+///
+/// @param index - a pointer to a YFast instance
+/// @param key - the key to find
+///
+/// @return the index of the containing range or RNG_NONE
+
+size_t yft_lookup(YFast index, ikey_t key);
+
+
+
+/// Get the bytes used by the index.
+///
+/// @param index - a pointer to a YFast instance
+///
+/// @return total size of the hash tables and buckets in bytes
+
+size_t yft_memory(YFast index);
+
+
+
+#endif  // YFAST_H